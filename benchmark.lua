@@ -0,0 +1,227 @@
+local defaults = {
+    name        = "default",
+    sprites     = 1000,
+    glyphs      = 256,
+    tilemap     = "64x64",
+    rotation    = "on",
+    framebuffer = "on",
+    resolution  = "window",
+    budget      = 0,
+    frames      = 600,
+    warmup      = 60,
+    seed        = 1,
+    width       = 800,
+    height      = 500
+}
+
+local GLYPH_LINE = "THE QUICK BROWN FOX JUMPS OVER 0123456789"
+
+function parse_options(args)
+    local options = {}
+
+    for key, value in pairs(defaults) do
+        options[key] = value
+    end
+
+    for i = 1, #args do
+        local key, value = string.match(args[i], "^([%w_]+)=(.*)$")
+
+        if key == nil or options[key] == nil then error("unknown option '" .. args[i] .. "'") end
+
+        options[key] = (type(defaults[key]) == "number") and tonumber(value) or value
+    end
+
+    local columns, rows = string.match(options.tilemap, "^(%d+)x(%d+)$")
+
+    options.tile_columns = tonumber(columns) or 0
+    options.tile_rows    = tonumber(rows)    or 0
+    options.rotation     = options.rotation    == "on"
+    options.framebuffer  = options.framebuffer == "on"
+
+    local render_width, render_height = string.match(options.resolution, "^(%d+)x(%d+)$")
+
+    options.render_width  = tonumber(render_width)
+    options.render_height = tonumber(render_height)
+    options.present       = options.render_width ~= nil or options.budget > 0
+
+    if options.frames < 1 then error("frames must be at least 1") end
+
+    return options
+end
+
+function percentile(sorted, p)
+    local index = math.ceil(p * #sorted)
+
+    if index < 1 then index = 1 end
+
+    return sorted[index]
+end
+
+function summarize(samples)
+    local sorted = {}
+    local total  = 0.0
+
+    for i = 1, #samples do
+        sorted[i] = samples[i]
+        total     = total + samples[i]
+    end
+
+    table.sort(sorted)
+
+    return string.format("{\"mean\":%.4f,\"p50\":%.4f,\"p99\":%.4f,\"max\":%.4f}",
+        total / #sorted, percentile(sorted, 0.5), percentile(sorted, 0.99), sorted[#sorted])
+end
+
+function create_sprites(options, aspect)
+    local sprites = {}
+
+    for i = 1, options.sprites do
+        local mesh = engine.create_mesh()
+
+        mesh:set_scale   (0.02, 0.02)
+        mesh:set_position((math.random() * 2.0 - 1.0) * aspect, math.random() * 2.0 - 1.0, 0.0)
+        mesh:set_rotate  (math.random() * 360.0)
+
+        sprites[i] = mesh
+    end
+
+    return sprites
+end
+
+function create_lines(options)
+    local lines = {}
+    local count = options.glyphs
+
+    while count > 0 do
+        local length = math.min(count, #GLYPH_LINE)
+
+        lines[#lines + 1] = string.sub(GLYPH_LINE, 1, length)
+        count             = count - length
+    end
+
+    return lines
+end
+
+function create_ground(options, texture)
+    if options.tile_columns == 0 or options.tile_rows == 0 then return nil end
+
+    local ground = engine.create_tilemap(options.tile_columns, options.tile_rows, 0.05, texture, 8, 8)
+
+    for y = 0, options.tile_rows - 1 do
+        for x = 0, options.tile_columns - 1 do
+            ground:set_tile(x, y, 1 + (x + y) % 4)
+        end
+    end
+
+    ground:set_position(-options.tile_columns * 0.025, -options.tile_rows * 0.025, -0.1)
+
+    return ground
+end
+
+function script()
+    local options = parse_options(arg)
+    local window  = engine.create_window("Benchmark", options.width, options.height, "./img/icon.bmp", false)
+
+    if not window then error("could not create a window") end
+
+    math.randomseed(options.seed)
+
+    local aspect           = options.width / options.height
+    local framebuffer      = options.framebuffer and engine.create_framebuffer(window, options.render_width, options.render_height) or nil
+    local framebuffer_mesh = engine.create_mesh()
+
+    framebuffer_mesh:set_scale(aspect, 1.0)
+
+    local atlas, textures = engine.create_atlas({"./img/player.bmp", "./img/stone.bmp", "./img/fontmap.bmp"})
+
+    local shader        = engine.create_shader("./glsl/vertex.glsl", "./glsl/fragment.glsl")
+    local opaque_shader = engine.create_shader("./glsl/vertex.glsl", "./glsl/opaque.glsl")
+    local ground_shader = textures[2]:opaque() and opaque_shader or shader
+    local font          = engine.create_font  (textures[3], 16, 16)
+    local sprites       = create_sprites      (options, aspect)
+    local lines         = create_lines        (options)
+    local ground        = create_ground       (options, textures[2])
+
+    local frame_times = {}
+    local cpu_times   = {}
+    local draw_calls  = {}
+    local angle       = 0.0
+
+    if framebuffer and options.budget > 0 then framebuffer:set_dynamic_resolution(options.budget) end
+
+    window:set_vsync(false)
+
+    for frame = 1, options.warmup + options.frames do
+        local frame_start = engine.time    ()
+        local cpu_start   = engine.cpu_time()
+
+        if options.rotation then
+            angle = angle + 1.0
+
+            for i = 1, #sprites do
+                sprites[i]:set_rotate(angle + i)
+            end
+        end
+
+        if framebuffer and options.present then
+            framebuffer:enable(0.5, 0.5, 1.0, 1.0)
+        elseif framebuffer then
+            framebuffer:enable()
+        else
+            engine.clear_color(0.5, 0.5, 1.0)
+        end
+
+        engine.begin_batch()
+
+        if ground then ground:draw(window, ground_shader) end
+
+        for i = 1, #sprites do
+            sprites[i]:draw(window, shader, textures[1], 0.0, 0.0, 0.0625, 0.0625)
+        end
+
+        for i = 1, #lines do
+            font:draw(window, shader, lines[i], -aspect, 0.95 - i * 0.05, 0.04)
+        end
+
+        engine.end_batch()
+
+        if framebuffer and options.present then
+            framebuffer:present(0.0, 0.0, 0.0)
+        elseif framebuffer then
+            framebuffer:disable(0.5, 0.5, 1.0)
+            framebuffer_mesh:draw(window, shader, framebuffer:texture(), 0.0, 0.0, 1.0, 1.0)
+        end
+
+        window:swap_buffers()
+        engine.finish      ()
+
+        if frame > options.warmup then
+            local stats = engine.get_frame_stats()
+
+            frame_times[#frame_times + 1] = (engine.time    () - frame_start) * 1000.0
+            cpu_times  [#cpu_times   + 1] = (engine.cpu_time() - cpu_start)   * 1000.0
+            draw_calls [#draw_calls  + 1] = stats.draw_calls
+        end
+    end
+
+    print(string.format(
+        "{\"name\":\"%s\",\"sprites\":%d,\"glyphs\":%d,\"tilemap\":\"%s\",\"rotation\":%s,\"framebuffer\":%s,\"resolution\":\"%s\",\"budget\":%g,\"frames\":%d,\"frame_time_ms\":%s,\"cpu_time_ms\":%s,\"draw_calls\":%s}",
+        options.name, options.sprites, options.glyphs, options.tilemap, tostring(options.rotation), tostring(options.framebuffer), options.resolution, options.budget, options.frames,
+        summarize(frame_times), summarize(cpu_times), summarize(draw_calls)))
+
+    for i = 1, #sprites do
+        sprites[i]:delete()
+    end
+
+    if ground then ground:delete() end
+
+    font            :delete()
+    framebuffer_mesh:delete()
+    shader          :delete()
+    opaque_shader   :delete()
+    atlas           :delete()
+
+    if framebuffer then framebuffer:delete() end
+
+    window:delete()
+end
@@ -0,0 +1,10 @@
+#version 330 core
+
+uniform sampler2D Sampler;
+
+out vec4 FragColor;
+in  vec2 UV;
+
+void main() {
+    FragColor = vec4(texture(Sampler, UV).rgb, 1.0f);
+}
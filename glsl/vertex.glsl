@@ -2,12 +2,13 @@
 
 layout(location = 0) in vec2 Position;
 layout(location = 1) in vec2 Texture;
+layout(location = 2) in mat4 Model;
+layout(location = 6) in vec4 TexCoords;
 
-uniform mat4 Model;
 uniform mat4 Projection;
 out vec2     UV;
 
 void main() {
     gl_Position = Projection * Model * vec4(Position, 0.0f, 1.0f);
-    UV          = Texture;
+    UV          = TexCoords.xy + Texture * TexCoords.zw;
 }
@@ -4,6 +4,10 @@
 #include <memory.h>
 #include <time.h>
 #include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 
 #define GLEW_STATIC
 #define STB_IMAGE_IMPLEMENTATION
@@ -17,6 +21,20 @@
 #include "./lua54/lauxlib.h"
 #include "./stb/stb_image.h"
 #include "./FastNoiseLite/FastNoiseLite.h"
+#include "./pack.h"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#elif _WIN32
+#include <windows.h>
+#endif
 
 #ifdef __linux__
 const char* OS = "Linux";
@@ -24,18 +42,32 @@ const char* OS = "Linux";
 const char* OS = "Windows";
 #endif
 
+typedef struct {
+    GLvoid*              pointer;
+    struct ResourcePool* pool;
+    uint32_t             id;
+} Handle;
+
+#define HANDLE_WINDOW       "engine.Window"
+#define HANDLE_FRAMEBUFFER  "engine.Framebuffer"
+#define HANDLE_SHADER       "engine.Shader"
+#define HANDLE_TEXTURE      "engine.Texture"
+#define HANDLE_ATLAS        "engine.Atlas"
+#define HANDLE_MESH         "engine.Mesh"
+#define HANDLE_TILEMAP      "engine.Tilemap"
+#define HANDLE_NOISE        "engine.Noise"
+#define HANDLE_FLOAT_BUFFER "engine.FloatBuffer"
+#define HANDLE_WORLD        "engine.World"
+#define HANDLE_FONT         "engine.Font"
+#define HANDLE_ENTITY       "engine.Entity"
+#define HANDLE_CAMERA       "engine.Camera"
+
 typedef struct {
     GLFWwindow* window;
     GLint       width;
     GLint       height;
 } Window;
 
-typedef struct {
-    GLuint FBO;
-    GLuint texture;
-    GLuint RBO;
-} Framebuffer;
-
 typedef struct {
     GLfloat v[2];
 } Vec2;
@@ -60,14 +92,678 @@ typedef struct {
     GLfloat m[4][4];
 } Mat4;
 
+typedef enum {
+    TEXTURE_QUEUED,
+    TEXTURE_DECODED,
+    TEXTURE_READY
+} TextureState;
+
+typedef struct Texture {
+    GLuint          ID;
+    Vec4            rect;
+    bool            shared;
+    GLchar*         path;
+    GLint           references;
+    TextureState    state;
+    GLubyte*        pixels;
+    bool            mapped;
+    bool            opaque;
+    GLint           width;
+    GLint           height;
+    GLint           uploaded_rows;
+    struct Texture* next;
+    struct Texture* next_job;
+} Texture;
+
+#define FRAMEBUFFER_QUERIES 4
+#define RESOLUTION_COOLDOWN 30
+#define RESOLUTION_HEADROOM 0.75
+#define RESOLUTION_DOWN     0.85f
+#define RESOLUTION_UP       1.1f
+
+typedef struct {
+    GLuint   FBO;
+    Texture  texture;
+    GLuint   RBO;
+    GLint    window_width;
+    GLint    window_height;
+    GLint    render_width;
+    GLint    render_height;
+    GLenum   filter;
+    GLfloat  scale;
+    GLfloat  target_scale;
+    GLfloat  min_scale;
+    GLdouble budget;
+    GLdouble gpu_time;
+    GLint    cooldown;
+    GLuint   queries[FRAMEBUFFER_QUERIES][2];
+    GLint    query_index;
+    GLint    query_count;
+    bool     timing;
+} Framebuffer;
+
+typedef struct {
+    GLuint*  pages;
+    GLint    page_count;
+    Texture* textures;
+    GLint    texture_count;
+} Atlas;
+
+typedef struct {
+    GLint x;
+    GLint y;
+    GLint width;
+} SkylineNode;
+
+typedef struct {
+    GLubyte*     pixels;
+    GLint        width;
+    GLint        height;
+    SkylineNode* skyline;
+    GLint        node_count;
+} AtlasPage;
+
+typedef struct {
+    GLubyte* pixels;
+    bool     mapped;
+    bool     opaque;
+    GLint    index;
+    GLint    width;
+    GLint    height;
+    GLint    page;
+    GLint    x;
+    GLint    y;
+} AtlasImage;
+
+typedef struct {
+    GLfloat* position_x;
+    GLfloat* position_y;
+    GLfloat* position_z;
+    GLfloat* scale_x;
+    GLfloat* scale_y;
+    GLfloat* cosine;
+    GLfloat* sine;
+    Mat4*    models;
+    GLuint*  parents;
+    GLuint*  versions;
+    GLuint*  parent_versions;
+    GLuint*  resolved;
+    GLubyte* dirty;
+    bool*    used;
+    GLuint*  free_list;
+    GLuint   count;
+    GLuint   free_count;
+    GLuint   capacity;
+    GLuint   dirty_count;
+    GLuint   child_count;
+    GLuint   pass;
+} MeshPool;
+
+#define COMPONENT_TRANSFORM 0x1u
+#define COMPONENT_VELOCITY  0x2u
+#define COMPONENT_SPRITE    0x4u
+#define COMPONENT_ANIMATION 0x8u
+#define ENTITY_ALIVE        0x80000000u
+
+typedef struct {
+    GLuint*   masks;
+    GLfloat*  position_x;
+    GLfloat*  position_y;
+    GLfloat*  position_z;
+    GLfloat*  scale_x;
+    GLfloat*  scale_y;
+    GLfloat*  cosine;
+    GLfloat*  sine;
+    GLfloat*  velocity_x;
+    GLfloat*  velocity_y;
+    Handle*   textures;
+    Vec4*     cells;
+    GLfloat*  first_frame;
+    GLfloat*  frame_count;
+    GLfloat*  frame_rate;
+    GLfloat*  frame_time;
+    GLuint*   free_list;
+    GLuint    count;
+    GLuint    free_count;
+    GLuint    capacity;
+} EntityStore;
+
+#define SPATIAL_BUCKETS   65536
+#define SPATIAL_CELL_SIZE 0.25f
+#define MESH_REGISTRY     "engine.meshes"
+
+typedef enum {
+    COLLIDER_NONE,
+    COLLIDER_ACTIVE,
+    COLLIDER_PENDING
+} ColliderState;
+
+typedef struct {
+    GLuint* items;
+    GLuint  count;
+    GLuint  capacity;
+} SpatialBucket;
+
+typedef struct {
+    SpatialBucket* buckets;
+    GLfloat        cell_size;
+    Vec4*          bounds;
+    GLint*         ranges;
+    GLuint*        stamps;
+    GLubyte*       states;
+    GLuint*        pending;
+    GLuint         pending_count;
+    GLuint*        results;
+    GLuint         result_count;
+    GLuint         capacity;
+    GLuint         stamp;
+} SpatialHash;
+
+typedef struct {
+    GLuint  program;
+    GLint   Projection;
+    GLint   Sampler;
+    GLfloat aspect;
+    GLuint  view;
+} Shader;
+
+#define PROGRAM_CACHE_MAGIC     0x42505247u
+#define PROGRAM_CACHE_DIRECTORY "./cache"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t format;
+    uint64_t key;
+    uint32_t length;
+    uint32_t reserved;
+} ProgramCacheHeader;
+
+typedef struct {
+    Mat4 Model;
+    Vec4 TexCoords;
+} Instance;
+
+typedef struct {
+    GLuint    VAO;
+    GLuint    VBO;
+    GLuint    EBO;
+    GLuint    instance_VBO;
+    Instance* instances;
+    GLsizei   count;
+    Shader*   shader;
+    GLuint    texture;
+    GLfloat   aspect;
+    bool      active;
+    GLuint    draw_calls;
+} Batch;
+
+typedef struct {
+    GLuint program;
+    GLuint texture;
+    GLuint VAO;
+    GLuint issued;
+    GLuint skipped;
+    GLuint draws;
+    GLuint uploads;
+} RenderState;
+
+typedef struct {
+    Vec2    position;
+    GLfloat zoom;
+    GLfloat cosine;
+    GLfloat sine;
+} Camera;
+
+typedef struct {
+    Camera* camera;
+    GLuint  version;
+    GLuint  resolved;
+    GLfloat aspect;
+    Vec4    bounds;
+    GLuint  drawn;
+    GLuint  culled;
+    GLuint  last_drawn;
+    GLuint  last_culled;
+} View;
+
+#define MAX_BATCH_INSTANCES 4096
+#define RADIX_BUCKETS       256
+
+typedef enum {
+    SORT_NONE,
+    SORT_STATE,
+    SORT_Z,
+    SORT_Y
+} SortMode;
+
+typedef struct {
+    Instance instance;
+    Shader*  shader;
+    GLuint   texture;
+    GLfloat  aspect;
+    GLubyte  layer;
+} QueuedDraw;
+
+typedef struct {
+    QueuedDraw* items;
+    uint64_t*   keys;
+    uint64_t*   key_scratch;
+    uint32_t*   order;
+    uint32_t*   order_scratch;
+    GLuint      count;
+    GLuint      capacity;
+    SortMode    mode;
+    GLubyte     layer;
+    GLuint      submitted;
+    GLuint      changes_before;
+    GLuint      changes_after;
+} RenderQueue;
+#define MESH_POOL_CAPACITY  256
+#define MAX_FRAME_TIME      0.25
+#define ATLAS_PAGE_SIZE     1024
+
+typedef struct {
+    const GLubyte*   data;
+    size_t           size;
+    const PackEntry* entries;
+    GLuint           entry_count;
+#ifdef __linux__
+    int              file;
+#elif _WIN32
+    HANDLE           file;
+    HANDLE           mapping;
+#endif
+} Pack;
+
+#define TILEMAP_CHUNK_SIZE 32
+#define TILEMAP_CHUNK_TILES (TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE)
+
 typedef struct {
     GLuint  VAO;
     GLuint  VBO;
-    GLuint  EBO;
-    Vec3    position;
-    Vec2    scale;
-    GLfloat angle_of_rotation;
-} Mesh;
+    GLsizei quad_count;
+    bool    dirty;
+} TilemapChunk;
+
+typedef struct {
+    Handle  texture;
+    Vec4    rect;
+    GLint   columns;
+    GLint   rows;
+    GLfloat tile_size;
+} TileSheet;
+
+typedef struct {
+    uint16_t*     tiles;
+    GLint         width;
+    GLint         height;
+    TileSheet     sheet;
+    Vec3          position;
+    TilemapChunk* chunks;
+    GLint         chunk_columns;
+    GLint         chunk_rows;
+    GLuint        EBO;
+    GLfloat*      vertices;
+} Tilemap;
+
+typedef struct {
+    fnl_state state;
+    bool      warp;
+} Noise;
+
+typedef struct {
+    GLfloat* data;
+    size_t   count;
+} FloatBuffer;
+
+typedef struct {
+    Noise*   noise;
+    GLfloat  x;
+    GLfloat  y;
+    GLfloat  step;
+    GLint    width;
+    GLint    first_row;
+    GLint    last_row;
+    GLfloat* out;
+} NoiseJob;
+
+#define MAX_NOISE_THREADS     16
+#define NOISE_THREAD_SAMPLES  16384
+#define MAX_NOISE_LEVELS      64
+
+typedef struct {
+    GLfloat  values[MAX_NOISE_LEVELS];
+    uint16_t tiles [MAX_NOISE_LEVELS];
+    GLint    count;
+} NoiseLevels;
+
+typedef enum {
+    CHUNK_QUEUED,
+    CHUNK_WORKING,
+    CHUNK_GENERATED,
+    CHUNK_READY
+} ChunkState;
+
+typedef struct WorldChunk {
+    GLint              x;
+    GLint              y;
+    ChunkState         state;
+    uint16_t           tiles[TILEMAP_CHUNK_TILES];
+    GLfloat*           vertices;
+    GLsizei            quad_count;
+    TilemapChunk       mesh;
+    GLuint             last_used;
+    GLdouble           queued_time;
+    struct WorldChunk* next;
+    struct WorldChunk* next_job;
+} WorldChunk;
+
+#define WORLD_BUCKETS     1024
+#define MAX_WORLD_THREADS 4
+
+typedef struct {
+    Noise           noise;
+    NoiseLevels     levels;
+    TileSheet       sheet;
+    GLint           radius;
+    size_t          memory_cap;
+    size_t          memory;
+    WorldChunk*     buckets[WORLD_BUCKETS];
+    WorldChunk*     jobs;
+    WorldChunk*     done;
+    pthread_t       workers[MAX_WORLD_THREADS];
+    GLint           worker_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t  job_ready;
+    bool            running;
+    GLint           focus_x;
+    GLint           focus_y;
+    GLuint          EBO;
+    GLuint          frame;
+    GLdouble        budget;
+    GLuint          generated;
+    GLuint          evicted;
+    GLuint          cached;
+    GLdouble        total_latency;
+    GLdouble        max_latency;
+} World;
+
+typedef struct TextRun {
+    GLchar*         text;
+    GLuint          hash;
+    TilemapChunk    mesh;
+    GLuint          last_used;
+    struct TextRun* next;
+} TextRun;
+
+#define TEXT_CACHE_BUCKETS  64
+#define TEXT_CACHE_CAPACITY 256
+#define FONT_GLYPHS         128
+
+typedef struct {
+    TileSheet sheet;
+    uint16_t  glyphs[FONT_GLYPHS];
+    TextRun*  buckets[TEXT_CACHE_BUCKETS];
+    GLint     run_count;
+    GLuint    clock;
+    GLuint    EBO;
+    uint16_t* tiles;
+    GLfloat*  vertices;
+} Font;
+
+#define TEXTURE_CACHE_BUCKETS 256
+#define TEXTURE_UPLOAD_ROWS   64
+#define TEXTURE_CHANNELS      4
+#define MAX_LOADER_THREADS    4
+
+typedef struct {
+    Texture*        buckets[TEXTURE_CACHE_BUCKETS];
+    Texture*        jobs;
+    Texture*        last_job;
+    Texture*        decoded;
+    Texture*        last_decoded;
+    pthread_t       workers[MAX_LOADER_THREADS];
+    GLint           worker_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t  job_ready;
+    pthread_cond_t  job_done;
+    bool            running;
+    GLuint          PBO;
+    GLdouble        budget;
+} TextureCache;
+
+#define PROFILE_NAME_SIZE    32
+#define PROFILE_FRAME_SCOPES 1024
+#define PROFILE_DEPTH        32
+#define PROFILE_PASSES       16
+#define PROFILE_QUERY_FRAMES 4
+
+typedef struct {
+    GLchar   name[PROFILE_NAME_SIZE];
+    GLdouble start;
+    GLdouble duration;
+    GLint    depth;
+    bool     gpu;
+} ProfileScope;
+
+typedef struct {
+    ProfileScope scopes[PROFILE_FRAME_SCOPES];
+    GLint        count;
+    GLdouble     frame_time;
+    GLuint       draw_calls;
+    GLuint       state_changes;
+    GLuint       texture_uploads;
+    size_t       lua_memory;
+} ProfileFrame;
+
+typedef struct {
+    GLchar   name[PROFILE_NAME_SIZE];
+    GLuint   queries[PROFILE_QUERY_FRAMES];
+    GLdouble starts [PROFILE_QUERY_FRAMES];
+    bool     pending[PROFILE_QUERY_FRAMES];
+    GLuint   next;
+    GLdouble time;
+} ProfilePass;
+
+typedef struct {
+    ProfileFrame  frames[2];
+    GLint         current;
+    GLint         stack [PROFILE_DEPTH];
+    GLint         passes[PROFILE_DEPTH];
+    GLint         depth;
+    ProfilePass   pass_list[PROFILE_PASSES];
+    GLint         pass_count;
+    GLint         active_pass;
+    GLdouble      frame_start;
+    GLuint        draws;
+    GLuint        issued;
+    GLuint        uploads;
+    ProfileScope* capture;
+    size_t        capture_count;
+    size_t        capture_capacity;
+    GLint         capture_frames;
+    GLdouble      capture_origin;
+    GLchar*       capture_path;
+} Profiler;
+
+#define INPUT_KEYS    (GLFW_KEY_LAST + 1)
+#define INPUT_WORDS   ((INPUT_KEYS + 31) / 32)
+#define INPUT_EVENTS  256
+#define INPUT_MAGIC   "INPT"
+#define INPUT_VERSION 1u
+
+typedef enum {
+    INPUT_LIVE,
+    INPUT_RECORDING,
+    INPUT_REPLAYING
+} InputMode;
+
+typedef struct {
+    uint16_t key;
+    uint16_t action;
+} InputEvent;
+
+typedef struct {
+    uint32_t   live    [INPUT_WORDS];
+    uint32_t   current [INPUT_WORDS];
+    uint32_t   previous[INPUT_WORDS];
+    uint32_t   snapshot[INPUT_WORDS];
+    InputEvent pending [INPUT_EVENTS];
+    InputEvent events  [INPUT_EVENTS];
+    GLint      pending_count;
+    GLint      event_count;
+    InputMode  mode;
+    FILE*      file;
+    GLuint     frame;
+} Input;
+
+#define RENDER_LISTS 3
+
+typedef enum {
+    COMMAND_CLEAR,
+    COMMAND_BIND_FRAMEBUFFER,
+    COMMAND_UNBIND_FRAMEBUFFER,
+    COMMAND_PRESENT_FRAMEBUFFER,
+    COMMAND_INSTANCES,
+    COMMAND_TILEMAP,
+    COMMAND_TILEMAP_CHUNK,
+    COMMAND_TEXT
+} CommandType;
+
+typedef struct {
+    CommandType type;
+    GLvoid*     target;
+    Shader*     shader;
+    GLuint      texture;
+    Mat4        projection;
+    Vec4        values;
+    GLint       range[4];
+} RenderCommand;
+
+typedef struct {
+    RenderCommand* commands;
+    GLsizei        command_count;
+    GLsizei        command_capacity;
+    Instance*      instances;
+    GLsizei        instance_count;
+    GLsizei        instance_capacity;
+    GLchar*        text;
+    size_t         text_size;
+    size_t         text_capacity;
+    GLfloat*       vertices;
+    size_t         vertex_count;
+    size_t         vertex_capacity;
+} CommandList;
+
+typedef struct {
+    GLvoid  (*release)(GLvoid*);
+    GLvoid* pointer;
+} RetiredResource;
+
+typedef struct {
+    CommandList      lists[RENDER_LISTS];
+    GLint            writing;
+    GLint            ready;
+    GLint            reading;
+    Window*          window;
+    pthread_t        thread;
+    pthread_mutex_t  mutex;
+    pthread_cond_t   list_ready;
+    pthread_cond_t   list_taken;
+    bool             running;
+    GLuint           submitted;
+    GLuint           rendered;
+    GLuint           dropped;
+    RenderState      stats;
+    RetiredResource* retired;
+    GLint            retired_count;
+    GLint            retired_capacity;
+    bool             draining;
+} Renderer;
+
+#define RESOURCE_SLAB_BYTES  16384u
+#define RESOURCE_INDEX_BITS  20u
+#define RESOURCE_INDEX_MASK  ((1u << RESOURCE_INDEX_BITS) - 1u)
+#define RESOURCE_GENERATIONS (1u << (32u - RESOURCE_INDEX_BITS))
+
+typedef enum {
+    RESOURCE_WINDOW,
+    RESOURCE_FRAMEBUFFER,
+    RESOURCE_SHADER,
+    RESOURCE_TEXTURE,
+    RESOURCE_ATLAS,
+    RESOURCE_TILEMAP,
+    RESOURCE_NOISE,
+    RESOURCE_FLOAT_BUFFER,
+    RESOURCE_WORLD,
+    RESOURCE_FONT,
+    RESOURCE_CAMERA,
+    RESOURCE_TYPES
+} ResourceType;
+
+typedef struct {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t gpu_bytes;
+} ResourceHeader;
+
+typedef struct ResourcePool {
+    const GLchar* name;
+    size_t        size;
+    size_t        stride;
+    GLuint        slots;
+    GLubyte**     slabs;
+    uint16_t*     generations;
+    GLuint*       free_list;
+    GLuint        slab_count;
+    GLuint        count;
+    GLuint        free_count;
+    GLuint        capacity;
+    GLuint        live;
+    GLuint        peak;
+    uint64_t      gpu_bytes;
+} ResourcePool;
+
+static Batch       batch;
+static RenderState render_state;
+static Camera      default_camera = { .zoom = 1.0f, .cosine = 1.0f };
+static View        view           = { .camera = &default_camera, .version = 1u };
+static Profiler    profiler       = { .active_pass = -1 };
+static Input       input;
+static RenderQueue render_queue;
+static CommandList* recording;
+static Renderer    renderer       = {
+    .mutex      = PTHREAD_MUTEX_INITIALIZER,
+    .list_ready = PTHREAD_COND_INITIALIZER,
+    .list_taken = PTHREAD_COND_INITIALIZER
+};
+static MeshPool    mesh_pool;
+static EntityStore entities;
+static FloatBuffer scratch_floats;
+static SpatialHash spatial = { .cell_size = SPATIAL_CELL_SIZE };
+static GLdouble    delay_tolerance = 0.002;
+
+static ResourcePool resources[RESOURCE_TYPES] = {
+    [RESOURCE_WINDOW]       = { .name = "window",       .size = sizeof(Window)      },
+    [RESOURCE_FRAMEBUFFER]  = { .name = "framebuffer",  .size = sizeof(Framebuffer) },
+    [RESOURCE_SHADER]       = { .name = "shader",       .size = sizeof(Shader)      },
+    [RESOURCE_TEXTURE]      = { .name = "texture",      .size = sizeof(Texture)     },
+    [RESOURCE_ATLAS]        = { .name = "atlas",        .size = sizeof(Atlas)       },
+    [RESOURCE_TILEMAP]      = { .name = "tilemap",      .size = sizeof(Tilemap)     },
+    [RESOURCE_NOISE]        = { .name = "noise",        .size = sizeof(Noise)       },
+    [RESOURCE_FLOAT_BUFFER] = { .name = "float_buffer", .size = sizeof(FloatBuffer) },
+    [RESOURCE_WORLD]        = { .name = "world",        .size = sizeof(World)       },
+    [RESOURCE_FONT]         = { .name = "font",         .size = sizeof(Font)        },
+    [RESOURCE_CAMERA]       = { .name = "camera",       .size = sizeof(Camera)      }
+};
+
+static Pack         pack;
+static TextureCache texture_cache = {
+    .mutex     = PTHREAD_MUTEX_INITIALIZER,
+    .job_ready = PTHREAD_COND_INITIALIZER,
+    .job_done  = PTHREAD_COND_INITIALIZER,
+    .budget    = 0.002
+};
 
 static int create_window          (lua_State*);
 static int delete_window          (lua_State*);
@@ -77,28 +773,254 @@ static int swap_buffers           (lua_State*);
 static int clear_color            (lua_State*);
 static int poll_events            (lua_State*);
 static int delay                  (lua_State*);
+static int get_time               (lua_State*);
+static int get_cpu_time           (lua_State*);
+static int finish                 (lua_State*);
+static int set_delay_tolerance    (lua_State*);
+static int set_vsync              (lua_State*);
+static int run                    (lua_State*);
+static int run_threaded           (lua_State*);
+static int get_render_stats       (lua_State*);
+static int get_resource_stats     (lua_State*);
 static int get_key                (lua_State*);
+static int key_pressed            (lua_State*);
+static int key_released           (lua_State*);
+static int get_input_events       (lua_State*);
+static int record_input           (lua_State*);
+static int replay_input           (lua_State*);
+static int stop_input_lua         (lua_State*);
 static int get_system_info        (lua_State*);
 static int create_framebuffer     (lua_State*);
 static int delete_framebuffer     (lua_State*);
 static int enable_framebuffer     (lua_State*);
 static int disable_framebuffer    (lua_State*);
 static int use_framebuffer        (lua_State*);
+static int present_framebuffer_lua(lua_State*);
+static int set_dynamic_resolution (lua_State*);
+static int get_resolution         (lua_State*);
 static int create_shader          (lua_State*);
 static int delete_shader          (lua_State*);
 static int load_texture           (lua_State*);
 static int delete_texture         (lua_State*);
+static int load_texture_async     (lua_State*);
+static int texture_ready          (lua_State*);
+static int texture_opaque         (lua_State*);
+static int set_upload_budget      (lua_State*);
+static int create_atlas           (lua_State*);
+static int delete_atlas           (lua_State*);
 static int create_mesh            (lua_State*);
 static int delete_mesh            (lua_State*);
 static int draw                   (lua_State*);
+static int begin_batch            (lua_State*);
+static int end_batch              (lua_State*);
+static int get_state_changes      (lua_State*);
+static int set_sort_mode          (lua_State*);
+static int set_layer              (lua_State*);
+static int get_sort_stats         (lua_State*);
 static int set_position           (lua_State*);
 static int set_scale              (lua_State*);
 static int set_rotate             (lua_State*);
+static int set_parent             (lua_State*);
+static int update_transforms_lua  (lua_State*);
+static int set_collider           (lua_State*);
+static int set_cell_size          (lua_State*);
+static int query_rect             (lua_State*);
+static int query_point            (lua_State*);
+static int overlaps               (lua_State*);
+static int sweep_tilemap          (lua_State*);
+static int create_tilemap         (lua_State*);
+static int delete_tilemap         (lua_State*);
+static int set_tile               (lua_State*);
+static int get_tile               (lua_State*);
+static int set_tilemap_position   (lua_State*);
+static int draw_tilemap           (lua_State*);
 static int create_noise           (lua_State*);
 static int get_noise              (lua_State*);
 static int delete_noise           (lua_State*);
+static int set_noise              (lua_State*);
+static int fill_noise             (lua_State*);
+static int fill_tilemap_noise     (lua_State*);
+static int create_float_buffer    (lua_State*);
+static int delete_float_buffer    (lua_State*);
+static int get_float              (lua_State*);
+static int set_float              (lua_State*);
+static int create_world           (lua_State*);
+static int delete_world           (lua_State*);
+static int update_world           (lua_State*);
+static int draw_world             (lua_State*);
+static int get_world_stats        (lua_State*);
+static int create_font            (lua_State*);
+static int delete_font            (lua_State*);
+static int draw_text              (lua_State*);
+static int create_entity          (lua_State*);
+static int delete_entity          (lua_State*);
+static int set_transform          (lua_State*);
+static int set_velocity           (lua_State*);
+static int set_sprite             (lua_State*);
+static int set_animation          (lua_State*);
+static int remove_component       (lua_State*);
+static int get_entity_position    (lua_State*);
+static int integrate_entities     (lua_State*);
+static int animate_entities       (lua_State*);
+static int draw_entities          (lua_State*);
+static int set_positions          (lua_State*);
+static int draw_meshes            (lua_State*);
+static int create_camera          (lua_State*);
+static int delete_camera          (lua_State*);
+static int set_camera             (lua_State*);
+static int use_camera             (lua_State*);
+static int get_cull_stats         (lua_State*);
+static int begin_scope            (lua_State*);
+static int end_scope              (lua_State*);
+static int begin_pass             (lua_State*);
+static int get_frame_stats        (lua_State*);
+static int capture_trace          (lua_State*);
 static int engine                 (lua_State*);
 
+static const luaL_Reg window_methods[] = {
+    {"delete",           delete_window},
+    {"should_close",     window_should_close},
+    {"set_should_close", set_window_should_close},
+    {"swap_buffers",     swap_buffers},
+    {"set_vsync",        set_vsync},
+    {"run",              run},
+    {"run_threaded",     run_threaded},
+    {"get_key",          get_key},
+    {"key_pressed",      key_pressed},
+    {"key_released",     key_released},
+    {"input_events",     get_input_events},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg framebuffer_methods[] = {
+    {"delete",                 delete_framebuffer},
+    {"enable",                 enable_framebuffer},
+    {"disable",                disable_framebuffer},
+    {"texture",                use_framebuffer},
+    {"present",                present_framebuffer_lua},
+    {"set_dynamic_resolution", set_dynamic_resolution},
+    {"resolution",             get_resolution},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg shader_methods[] = {
+    {"delete", delete_shader},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg texture_methods[] = {
+    {"delete", delete_texture},
+    {"ready",  texture_ready},
+    {"opaque", texture_opaque},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg atlas_methods[] = {
+    {"delete", delete_atlas},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg mesh_methods[] = {
+    {"delete",       delete_mesh},
+    {"draw",         draw},
+    {"set_position", set_position},
+    {"set_scale",    set_scale},
+    {"set_rotate",   set_rotate},
+    {"set_parent",   set_parent},
+    {"set_collider", set_collider},
+    {"overlaps",     overlaps},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg tilemap_methods[] = {
+    {"delete",       delete_tilemap},
+    {"set_tile",     set_tile},
+    {"get_tile",     get_tile},
+    {"set_position", set_tilemap_position},
+    {"draw",         draw_tilemap},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg noise_methods[] = {
+    {"delete",       delete_noise},
+    {"get",          get_noise},
+    {"set",          set_noise},
+    {"fill",         fill_noise},
+    {"fill_tilemap", fill_tilemap_noise},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg float_buffer_methods[] = {
+    {"delete", delete_float_buffer},
+    {"get",    get_float},
+    {"set",    set_float},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg world_methods[] = {
+    {"delete", delete_world},
+    {"update", update_world},
+    {"draw",   draw_world},
+    {"stats",  get_world_stats},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg font_methods[] = {
+    {"delete", delete_font},
+    {"draw",   draw_text},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg entity_methods[] = {
+    {"delete",           delete_entity},
+    {"set_transform",    set_transform},
+    {"set_velocity",     set_velocity},
+    {"set_sprite",       set_sprite},
+    {"set_animation",    set_animation},
+    {"remove_component", remove_component},
+    {"get_position",     get_entity_position},
+
+    {NULL, NULL}
+};
+
+static const luaL_Reg camera_methods[] = {
+    {"delete", delete_camera},
+    {"set",    set_camera},
+    {"use",    use_camera},
+
+    {NULL, NULL}
+};
+
+static const struct {
+    const GLchar*   name;
+    const luaL_Reg* methods;
+} handle_types[] = {
+    {HANDLE_WINDOW,       window_methods},
+    {HANDLE_FRAMEBUFFER,  framebuffer_methods},
+    {HANDLE_SHADER,       shader_methods},
+    {HANDLE_TEXTURE,      texture_methods},
+    {HANDLE_ATLAS,        atlas_methods},
+    {HANDLE_MESH,         mesh_methods},
+    {HANDLE_TILEMAP,      tilemap_methods},
+    {HANDLE_NOISE,        noise_methods},
+    {HANDLE_FLOAT_BUFFER, float_buffer_methods},
+    {HANDLE_WORLD,        world_methods},
+    {HANDLE_FONT,         font_methods},
+    {HANDLE_ENTITY,       entity_methods},
+    {HANDLE_CAMERA,       camera_methods}
+};
+
 static const luaL_Reg functions[] = {
     {"create_window",           create_window},
     {"delete_window",           delete_window},
@@ -108,36 +1030,285 @@ static const luaL_Reg functions[] = {
     {"swap_buffers",            swap_buffers},
     {"poll_events",             poll_events},
     {"delay",                   delay},
+    {"time",                    get_time},
+    {"cpu_time",                get_cpu_time},
+    {"finish",                  finish},
+    {"set_delay_tolerance",     set_delay_tolerance},
+    {"set_vsync",               set_vsync},
+    {"run",                     run},
+    {"run_threaded",            run_threaded},
+    {"get_render_stats",        get_render_stats},
+    {"get_resource_stats",      get_resource_stats},
     {"get_key",                 get_key},
+    {"key_pressed",             key_pressed},
+    {"key_released",            key_released},
+    {"get_input_events",        get_input_events},
+    {"record_input",            record_input},
+    {"replay_input",            replay_input},
+    {"stop_input",              stop_input_lua},
     {"get_system_info",         get_system_info},
     {"create_framebuffer",      create_framebuffer},
     {"delete_framebuffer",      delete_framebuffer},
     {"enable_framebuffer",      enable_framebuffer},
     {"disable_framebuffer",     disable_framebuffer},
     {"use_framebuffer",         use_framebuffer},
+    {"present_framebuffer",     present_framebuffer_lua},
+    {"set_dynamic_resolution",  set_dynamic_resolution},
+    {"get_resolution",          get_resolution},
     {"create_shader",           create_shader},
     {"delete_shader",           delete_shader},
     {"load_texture",            load_texture},
     {"delete_texture",          delete_texture},
+    {"load_texture_async",      load_texture_async},
+    {"texture_ready",           texture_ready},
+    {"texture_opaque",          texture_opaque},
+    {"set_upload_budget",       set_upload_budget},
+    {"create_atlas",            create_atlas},
+    {"delete_atlas",            delete_atlas},
     {"create_mesh",             create_mesh},
     {"delete_mesh",             delete_mesh},
     {"draw",                    draw},
+    {"begin_batch",             begin_batch},
+    {"end_batch",               end_batch},
+    {"get_state_changes",       get_state_changes},
+    {"set_sort_mode",           set_sort_mode},
+    {"set_layer",               set_layer},
+    {"get_sort_stats",          get_sort_stats},
     {"set_position",            set_position},
     {"set_scale",               set_scale},
     {"set_rotate",              set_rotate},
+    {"set_parent",              set_parent},
+    {"update_transforms",       update_transforms_lua},
+    {"set_collider",            set_collider},
+    {"set_cell_size",           set_cell_size},
+    {"query_rect",              query_rect},
+    {"query_point",             query_point},
+    {"overlaps",                overlaps},
+    {"sweep_tilemap",           sweep_tilemap},
+    {"create_tilemap",          create_tilemap},
+    {"delete_tilemap",          delete_tilemap},
+    {"set_tile",                set_tile},
+    {"get_tile",                get_tile},
+    {"set_tilemap_position",    set_tilemap_position},
+    {"draw_tilemap",            draw_tilemap},
     {"create_noise",            create_noise},
     {"get_noise",               get_noise},
     {"delete_noise",            delete_noise},
+    {"set_noise",               set_noise},
+    {"fill_noise",              fill_noise},
+    {"fill_tilemap_noise",      fill_tilemap_noise},
+    {"create_float_buffer",     create_float_buffer},
+    {"delete_float_buffer",     delete_float_buffer},
+    {"get_float",               get_float},
+    {"set_float",               set_float},
+    {"create_world",            create_world},
+    {"delete_world",            delete_world},
+    {"update_world",            update_world},
+    {"draw_world",              draw_world},
+    {"get_world_stats",         get_world_stats},
+    {"create_font",             create_font},
+    {"delete_font",             delete_font},
+    {"draw_text",               draw_text},
+    {"create_entity",           create_entity},
+    {"delete_entity",           delete_entity},
+    {"set_transform",           set_transform},
+    {"set_velocity",            set_velocity},
+    {"set_sprite",              set_sprite},
+    {"set_animation",           set_animation},
+    {"remove_component",        remove_component},
+    {"get_entity_position",     get_entity_position},
+    {"integrate_entities",      integrate_entities},
+    {"animate_entities",        animate_entities},
+    {"draw_entities",           draw_entities},
+    {"set_positions",           set_positions},
+    {"draw_meshes",             draw_meshes},
+    {"create_camera",           create_camera},
+    {"delete_camera",           delete_camera},
+    {"set_camera",              set_camera},
+    {"use_camera",              use_camera},
+    {"get_cull_stats",          get_cull_stats},
+    {"begin_scope",             begin_scope},
+    {"end_scope",               end_scope},
+    {"begin_pass",              begin_pass},
+    {"end_pass",                end_scope},
+    {"get_frame_stats",         get_frame_stats},
+    {"capture_trace",           capture_trace},
 
     {NULL, NULL}
 };
 
 GLvoid set_window_icon        (GLFWwindow*, const char*);
+GLvoid key_callback           (GLFWwindow*, int, int, int, int);
+bool   key_down               (const uint32_t*, GLint);
+bool   snapshot_input         (Input*, GLint*);
+GLvoid advance_input          (Input*);
+bool   read_input_frame       (Input*, GLint*);
+GLvoid write_input_frame      (Input*, GLint);
+GLvoid stop_input             (Input*);
+GLvoid check_context          (lua_State*);
+RenderCommand* push_command   (CommandList*, CommandType);
+GLvoid record_instances       (CommandList*, Batch*);
+bool   record_text            (CommandList*, const GLchar*, GLint*);
+GLfloat* reserve_vertices     (CommandList*, size_t);
+GLvoid record_tilemap_chunks  (CommandList*, Tilemap*, const GLint*);
+GLvoid execute_commands       (CommandList*);
+bool   start_renderer         (Renderer*, Window*);
+GLvoid publish_commands       (Renderer*, bool);
+GLvoid stop_renderer          (Renderer*);
+GLvoid* render_frames         (GLvoid*);
+GLvoid delete_renderer        (Renderer*);
+GLvoid retire_resource        (Renderer*, GLvoid (*)(GLvoid*), GLvoid*);
+GLvoid drain_retired          (Renderer*);
+GLvoid free_retired           (Renderer*);
+RenderState read_render_state (Renderer*);
+GLvoid free_framebuffer       (GLvoid*);
+GLvoid free_shader            (GLvoid*);
+GLvoid free_texture           (GLvoid*);
+GLvoid free_atlas             (GLvoid*);
+GLvoid free_tilemap           (GLvoid*);
+GLvoid free_world             (GLvoid*);
+GLvoid free_font              (GLvoid*);
+GLvoid  push_handle           (lua_State*, GLvoid*, const GLchar*);
+GLvoid  push_resource         (lua_State*, ResourceType, GLvoid*, GLvoid*, const GLchar*);
+GLvoid* handle_pointer        (Handle*);
+GLvoid*  alloc_resource       (ResourcePool*);
+GLvoid   free_resource        (ResourcePool*, GLvoid*);
+GLvoid*  get_resource         (ResourcePool*, uint32_t);
+uint32_t resource_id          (const GLvoid*);
+GLvoid   set_resource_bytes   (ResourcePool*, GLvoid*, uint64_t);
+GLvoid   report_resources     (GLvoid);
+GLvoid   delete_resources     (GLvoid);
+GLvoid* check_handle          (lua_State*, int, const GLchar*);
+GLvoid* take_handle           (lua_State*, int, const GLchar*);
+const GLfloat* check_floats   (lua_State*, int, size_t);
 char*  read_file              (const char*);
-GLuint compile_vertex_shader  (const GLchar*);
-GLuint compile_fragment_shader(const GLchar*);
+const GLchar* shader_source   (const GLchar*, GLchar**);
+GLuint   compile_shader       (GLenum, const GLchar*, const GLchar*);
+GLuint   build_program        (const GLchar*, const GLchar*, const GLchar*, const GLchar*);
+bool     check_program        (GLuint);
+uint64_t hash_bytes           (uint64_t, const GLvoid*, size_t);
+uint64_t program_key          (const GLchar*, const GLchar*);
+GLvoid   program_cache_path   (GLchar*, size_t, const GLchar*, const GLchar*);
+bool     program_binaries     (GLvoid);
+GLuint   load_program_binary  (const GLchar*, uint64_t);
+GLvoid   save_program_binary  (GLuint, const GLchar*, uint64_t);
 GLvoid setup_VBO              (GLuint*);
 GLvoid setup_EBO              (GLuint*);
+GLuint alloc_mesh             (MeshPool*);
+GLvoid free_mesh              (MeshPool*, GLuint);
+GLuint get_mesh               (MeshPool*, GLvoid*);
+GLvoid delete_mesh_pool       (MeshPool*);
+GLvoid mark_mesh_dirty        (MeshPool*, GLuint);
+Mat4*  mesh_model             (MeshPool*, GLuint);
+GLuint update_transforms      (MeshPool*);
+GLvoid local_transform        (MeshPool*, GLuint, Mat4*);
+GLvoid resolve_transform      (MeshPool*, GLuint);
+GLvoid compose_transform      (MeshPool*, GLuint, GLuint);
+GLvoid resolve_mesh           (MeshPool*, GLuint);
+bool   reserve_colliders      (SpatialHash*, GLuint);
+GLuint hash_cell              (GLint, GLint);
+GLvoid collider_bounds        (SpatialHash*, MeshPool*, GLuint);
+GLvoid insert_collider        (SpatialHash*, GLuint);
+GLvoid remove_collider        (SpatialHash*, GLuint);
+GLvoid update_colliders       (SpatialHash*, MeshPool*);
+GLuint query_colliders        (SpatialHash*, const Vec4*, GLuint);
+GLvoid collect_colliders      (SpatialHash*, const SpatialBucket*, const Vec4*, GLuint);
+GLvoid push_colliders         (lua_State*, SpatialHash*, int);
+bool   solid_tiles            (Tilemap*, GLint, GLint, GLint, GLint);
+GLint  clamp_tile             (GLfloat, GLint);
+GLvoid delete_spatial_hash    (SpatialHash*);
+GLint  skyline_fit            (AtlasPage*, GLint, GLint, GLint);
+bool   skyline_insert         (AtlasPage*, GLint, GLint, GLint*, GLint*);
+GLvoid blit_padded            (AtlasPage*, AtlasImage*, GLint);
+int    compare_heights        (const void*, const void*);
+GLuint   hash_path            (const GLchar*);
+Texture* acquire_texture      (TextureCache*, const GLchar*, bool);
+GLvoid   release_texture      (TextureCache*, Texture*);
+GLvoid   finish_texture       (TextureCache*, Texture*);
+GLvoid   upload_texture_rows  (TextureCache*, Texture*, GLint);
+GLvoid   upload_textures      (TextureCache*, GLdouble);
+GLvoid*  decode_textures      (GLvoid*);
+GLubyte* load_pixels          (const GLchar*, GLint*, GLint*, bool*);
+bool     opaque_pixels        (const GLubyte*, size_t);
+GLvoid   stop_texture_loader  (TextureCache*);
+GLint    processor_count      (GLvoid);
+bool     open_pack            (Pack*, const GLchar*);
+GLvoid   close_pack           (Pack*);
+const PackEntry* find_pack_entry(Pack*, const GLchar*, PackType);
+GLdouble monotonic_time       (GLvoid);
+GLdouble process_time         (GLvoid);
+GLvoid   sleep_for            (GLdouble);
+GLvoid   wait_until           (GLdouble);
+GLvoid setup_batch            (Batch*);
+GLvoid delete_batch           (Batch*);
+GLvoid flush_batch            (Batch*);
+Instance* push_instance       (Batch*, Shader*, GLuint, GLfloat);
+Instance* batch_instance      (Batch*, Shader*, GLuint, GLfloat);
+Instance* queue_instance      (RenderQueue*, Shader*, GLuint, GLfloat);
+uint32_t  sortable_float      (GLfloat);
+uint64_t  sort_key            (const RenderQueue*, const QueuedDraw*);
+GLvoid    radix_sort          (RenderQueue*, GLuint);
+GLuint    count_state_changes (const RenderQueue*, const uint32_t*, GLuint);
+GLvoid    submit_queue        (RenderQueue*, Batch*);
+GLvoid    delete_render_queue (RenderQueue*);
+GLvoid draw_instances         (Batch*, GLuint, const Instance*, GLsizei);
+GLvoid set_projection         (Shader*, const Mat4*);
+GLvoid clear_screen           (GLclampf, GLclampf, GLclampf);
+GLvoid bind_framebuffer       (Framebuffer*, const Vec4*, GLint, GLint, bool);
+GLvoid unbind_framebuffer     (Framebuffer*, GLclampf, GLclampf, GLclampf);
+GLvoid present_framebuffer    (Framebuffer*, GLint, GLint, GLclampf, GLclampf, GLclampf);
+GLvoid set_render_scale       (Framebuffer*, GLfloat);
+GLvoid update_resolution      (Framebuffer*);
+GLvoid apply_resolution       (Framebuffer*);
+GLvoid use_program            (GLuint);
+GLvoid bind_texture           (GLuint);
+GLvoid bind_vertex_array      (GLuint);
+GLvoid upload_projection      (Shader*, GLfloat);
+GLvoid  build_chunk           (Tilemap*, GLint, GLint);
+GLsizei fill_chunk            (Tilemap*, GLint, GLint, GLfloat*);
+GLsizei fill_tile_quads       (const TileSheet*, const uint16_t*, GLint, GLint, GLint, GLint, GLint, GLfloat*);
+GLvoid  upload_tile_quads     (TilemapChunk*, GLuint, const GLfloat*, GLsizei);
+GLuint  create_tile_indices   (GLvoid);
+GLvoid  begin_tile_draw       (Shader*, GLfloat, Texture*, const Vec3*, GLfloat);
+GLvoid  setup_tile_draw       (GLuint, const Vec3*, GLfloat);
+GLvoid  build_tilemap_chunks  (Tilemap*, const GLint*);
+GLint   draw_tilemap_chunks   (Tilemap*, const GLint*);
+GLfloat sample_noise          (Noise*, GLfloat, GLfloat);
+GLvoid* fill_noise_rows       (GLvoid*);
+GLvoid  generate_noise        (Noise*, GLfloat, GLfloat, GLfloat, GLint, GLint, GLfloat*);
+GLint    read_noise_levels    (lua_State*, int, NoiseLevels*);
+uint16_t classify_noise       (const NoiseLevels*, GLfloat);
+GLuint      hash_chunk          (GLint, GLint);
+WorldChunk* find_world_chunk    (World*, GLint, GLint);
+WorldChunk* take_world_job      (World*);
+GLvoid      unlink_world_job    (World*, WorldChunk*);
+GLvoid      generate_world_chunk(World*, WorldChunk*);
+GLvoid*     stream_world_chunks (GLvoid*);
+GLvoid      evict_world_chunk   (World*, WorldChunk*);
+int         compare_last_used   (const void*, const void*);
+TextRun*    find_text_run       (Font*, const GLchar*);
+bool        measure_text        (const GLchar*, GLint*, GLint*);
+TextRun*    build_text_run      (Font*, const GLchar*, GLuint);
+GLvoid      draw_text_run       (TextRun*);
+GLvoid      delete_text_run     (Font*, TextRun*);
+GLuint alloc_entity           (EntityStore*);
+GLvoid free_entity            (EntityStore*, GLuint);
+GLuint get_entity             (EntityStore*, GLvoid*);
+GLvoid delete_entity_store    (EntityStore*);
+GLvoid update_view            (View*, GLfloat);
+bool   cull_model             (View*, const Mat4*);
+GLvoid end_view_frame         (View*);
+Mat4   camera_projection      (const Camera*, GLfloat);
+GLvoid copy_profile_name      (GLchar*, const GLchar*);
+GLvoid begin_profile_scope    (Profiler*, const GLchar*);
+GLvoid end_profile_scope      (Profiler*);
+GLvoid begin_profile_pass     (Profiler*, const GLchar*);
+GLvoid read_profile_passes    (Profiler*);
+GLvoid capture_profile_scope  (Profiler*, const ProfileScope*);
+GLvoid end_profile_frame      (Profiler*, lua_State*);
+bool   write_trace            (Profiler*);
+GLvoid delete_profile_passes  (Profiler*);
+GLvoid delete_profiler        (Profiler*);
 Mat4   ortho                  (GLfloat, GLfloat, GLfloat, GLfloat, GLfloat, GLfloat);
 GLvoid identity               (Mat4*);
 GLvoid scale                  (Mat4*, GLfloat, GLfloat, GLfloat);
@@ -145,6 +1316,10 @@ GLvoid rotate                 (Mat4*, GLfloat);
 GLvoid translate              (Mat4*, GLfloat, GLfloat, GLfloat);
 
 int main(int argc, char* argv[]) {
+#ifdef _WIN32
+    timeBeginPeriod(1);
+#endif
+
     lua_State* L = luaL_newstate();
 
     luaL_openlibs(L);
@@ -161,19 +1336,78 @@ int main(int argc, char* argv[]) {
         lua_setglobal  (L, constant_name);
     }
 
+    const GLchar* script_path = (argc > 1) ? argv[1] : "./script.lua";
+    GLchar        chunk_name[256];
+    GLint         i           = 0;
+
+    lua_createtable(L, (argc > 2) ? argc - 2 : 0, 1);
+
+    for (i = 1; i < argc; i++) {
+        lua_pushstring(L, argv[i]);
+        lua_rawseti   (L, -2, i - 1);
+    }
+
+    lua_setglobal  (L, "arg");
     lua_pushinteger(L, GLFW_KEY_ESCAPE);
     lua_setglobal  (L, "KEY_ESC");
+    open_pack      (&pack, "./assets.pak");
+    snprintf       (chunk_name, sizeof(chunk_name), "@%s", script_path);
+
+    const PackEntry* script_entry = find_pack_entry(&pack, script_path, PACK_SCRIPT);
+    GLint            status       = LUA_OK;
+
+    if (script_entry != NULL) {
+        status = luaL_loadbuffer(L, (const GLchar*)&(pack.data[script_entry->offset]), script_entry->size, chunk_name);
+    } else {
+        status = luaL_loadfile(L, script_path);
+    }
 
-    if (luaL_dofile(L, "./script.lua") == LUA_OK) {
+    if (status == LUA_OK) status = lua_pcall(L, 0, LUA_MULTRET, 0);
+
+    if (status == LUA_OK) {
         lua_getglobal(L, "script");
-        lua_pcall    (L, 0, 0, 0);
-        lua_close    (L);
+
+        status = lua_pcall(L, 0, 0, 0);
+    }
+
+    if (status == LUA_OK) {
+        report_resources   ();
+        lua_close          (L);
+        delete_mesh_pool   (&mesh_pool);
+        delete_entity_store(&entities);
+        delete_spatial_hash(&spatial);
+        delete_profiler    (&profiler);
+        stop_input         (&input);
+        delete_renderer    (&renderer);
+        delete_render_queue(&render_queue);
+        delete_resources   ();
+        free               (scratch_floats.data);
+        close_pack         (&pack);
+
+#ifdef _WIN32
+        timeEndPeriod(1);
+#endif
 
         return EXIT_SUCCESS;
     }
 
-    printf   ("Error (%s): %s\n", __func__, lua_tostring(L, -1));
-    lua_close(L);
+    printf             ("Error (%s): %s\n", __func__, lua_tostring(L, -1));
+    report_resources   ();
+    lua_close          (L);
+    delete_mesh_pool   (&mesh_pool);
+    delete_entity_store(&entities);
+    delete_spatial_hash(&spatial);
+    delete_profiler    (&profiler);
+    stop_input         (&input);
+    delete_renderer    (&renderer);
+    delete_render_queue(&render_queue);
+    delete_resources   ();
+    free               (scratch_floats.data);
+    close_pack         (&pack);
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
 
     return EXIT_FAILURE;
 }
@@ -193,18 +1427,26 @@ static int create_window(lua_State* L) {
     const GLint        width     = luaL_checkinteger(L, 2);
     const GLint        height    = luaL_checkinteger(L, 3);
     const GLchar*      icon_path = luaL_checkstring (L, 4);
-    Window*            window    = malloc           (sizeof(Window));
+    const bool         visible   = lua_isnoneornil  (L, 5) || lua_toboolean(L, 5);
+    Window*            window    = alloc_resource   (&(resources[RESOURCE_WINDOW]));
     GLFWvidmode const* mode      = glfwGetVideoMode (glfwGetPrimaryMonitor());
 
-    window->window = glfwCreateWindow(width, height, title, NULL, NULL);
-    window->width  = width;
-    window->height = height;
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
-    if (window->window != NULL) {
+    if (window != NULL) {
+        window->window = glfwCreateWindow(width, height, title, NULL, NULL);
+        window->width  = width;
+        window->height = height;
+    }
+
+    if (window != NULL && window->window != NULL) {
         glfwMakeContextCurrent(window->window);
         glfwSetWindowAttrib   (window->window, GLFW_RESIZABLE, false);
-        glfwSetWindowPos      (window->window, (mode->width - window->width) / 2, (mode->height - window->height) / 2);
+
+        if (mode != NULL) glfwSetWindowPos(window->window, (mode->width - window->width) / 2, (mode->height - window->height) / 2);
+
         set_window_icon       (window->window, icon_path);
+        glfwSetKeyCallback    (window->window, key_callback);
         glEnable              (GL_DEPTH_TEST);
 
         glewExperimental = true;
@@ -213,37 +1455,48 @@ static int create_window(lua_State* L) {
             printf           ("Error (%s): Failed to initialize.\n", __func__);
             glfwDestroyWindow(window->window);
             glfwTerminate    ();
+            free_resource    (&(resources[RESOURCE_WINDOW]), window);
 
             return 0;
         }
 
-        lua_pushlightuserdata(L, window);
+        glEnable           (GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        setup_batch        (&batch);
+        push_resource      (L, RESOURCE_WINDOW, window, window, HANDLE_WINDOW);
 
         return 1;
     } else {
         printf       ("Error (%s): Failed to create window.", __func__);
         glfwTerminate();
 
+        if (window != NULL) free_resource(&(resources[RESOURCE_WINDOW]), window);
+
         return 0;
     }
 }
 
 static int delete_window(lua_State* L) {
-    Window* window = lua_touserdata(L, 1);
+    check_context(L);
 
-    if (window->window != NULL) {
-        glfwDestroyWindow(window->window);
+    Window* window = take_handle(L, 1, HANDLE_WINDOW);
+
+    if (window != NULL && window->window != NULL) {
+        stop_texture_loader  (&texture_cache);
+        delete_batch         (&batch);
+        delete_profile_passes(&profiler);
+        glfwDestroyWindow    (window->window);
         glfwTerminate    ();
-        free             (window);
+        free_resource    (&(resources[RESOURCE_WINDOW]), window);
     }
 
     return 0;
 }
 
 static int window_should_close(lua_State* L) {
-    Window* window = lua_touserdata(L, 1);
+    Window* window = check_handle(L, 1, HANDLE_WINDOW);
 
-    if (window->window != NULL) {
+    if (window != NULL && window->window != NULL) {
         lua_pushboolean(L, glfwWindowShouldClose(window->window));
 
         return 1;
@@ -253,9 +1506,9 @@ static int window_should_close(lua_State* L) {
 }
 
 static int set_window_should_close(lua_State* L) {
-    Window* window = lua_touserdata(L, 1);
+    Window* window = check_handle(L, 1, HANDLE_WINDOW);
 
-    if (window->window != NULL) glfwSetWindowShouldClose(window->window, true);
+    if (window != NULL && window->window != NULL) glfwSetWindowShouldClose(window->window, true);
 
     return 0;
 }
@@ -265,210 +1518,295 @@ static int clear_color(lua_State* L) {
     const GLclampf green = (GLclampf)lua_tonumber(L, 2);
     const GLclampf blue  = (GLclampf)lua_tonumber(L, 3);
 
-    glClear     (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glClearColor(red, green, blue, 1.0f);
+    flush_batch(&batch);
+
+    if (recording != NULL) {
+        RenderCommand* command = push_command(recording, COMMAND_CLEAR);
+
+        if (command != NULL) command->values = (Vec4){ .v = { red, green, blue, 1.0f } };
+    } else {
+        clear_screen(red, green, blue);
+    }
 
     return 0;
 }
 
 static int swap_buffers(lua_State* L) {
-    Window* window = lua_touserdata(L, 1);
-
-    if (window->window != NULL) glfwSwapBuffers(window->window);
+    check_context(L);
+
+    Window* window = check_handle(L, 1, HANDLE_WINDOW);
+
+    if (window != NULL && window->window != NULL) {
+        begin_profile_scope(&profiler, "present");
+        flush_batch        (&batch);
+        upload_textures    (&texture_cache, texture_cache.budget);
+        glfwSwapBuffers    (window->window);
+        end_profile_scope  (&profiler);
+        end_view_frame     (&view);
+        end_profile_frame  (&profiler, L);
+    }
 
     return 0;
 }
 
 static int poll_events(lua_State* L) {
     glfwPollEvents();
+    advance_input (&input);
 
-    return 0;
+    lua_pushboolean(L, snapshot_input(&input, NULL));
+
+    return 1;
 }
 
 static int delay(lua_State* L) {
-    const   GLdouble seconds = luaL_checknumber(L, 1);
-    clock_t start_time       = clock           ();
-    clock_t end_time         = start_time + (seconds * CLOCKS_PER_SEC);
+    const GLdouble seconds = luaL_checknumber(L, 1);
 
-    while (clock() < end_time) {};
+    wait_until(monotonic_time() + seconds);
 
     return 0;
 }
 
-static int get_key(lua_State* L) {
-    Window* window    = lua_touserdata   (L, 1);
-    const   GLint key = luaL_checkinteger(L, 2);
-
-    if (window->window != NULL) {
-        lua_pushboolean(L, glfwGetKey(window->window, key) == GLFW_PRESS);
-
-        return 1;
-    }
+static int get_time(lua_State* L) {
+    lua_pushnumber(L, monotonic_time());
 
-    return 0;
+    return 1;
 }
 
-static int get_system_info(lua_State* L) {
-    printf("SYSTEM:                   %s\n", OS);
-    printf("VENDOR:                   %s\n", glGetString(GL_VENDOR));
-    printf("RENDERER:                 %s\n", glGetString(GL_RENDERER));
-    printf("VERSION:                  %s\n", glGetString(GL_VERSION));
-    printf("SHADING LANGUAGE VERSION: %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
+static int get_cpu_time(lua_State* L) {
+    lua_pushnumber(L, process_time());
 
-    return 0;
+    return 1;
 }
 
-static int create_framebuffer(lua_State* L) {
-    Window*      window      = lua_touserdata(L, 1);
-    Framebuffer* framebuffer = malloc        (sizeof(Framebuffer));
-
-    if (framebuffer != NULL) {
-        glGenFramebuffers        (1, &(framebuffer->FBO));
-        glBindFramebuffer        (GL_FRAMEBUFFER, framebuffer->FBO);
-        glGenTextures            (1, &(framebuffer->texture));
-        glBindTexture            (GL_TEXTURE_2D, framebuffer->texture);
-        glTexImage2D             (GL_TEXTURE_2D, 0, GL_RGB, window->width, window->height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri          (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri          (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glFramebufferTexture2D   (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, framebuffer->texture, 0);
-        glGenRenderbuffers       (1, &(framebuffer->RBO));
-        glBindRenderbuffer       (GL_RENDERBUFFER, framebuffer->RBO);
-        glRenderbufferStorage    (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, window->width, window->height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, framebuffer->RBO);
-
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            printf("Error (%s): Framebuffer is not complete.\n", __func__);
-        }
+static int finish(lua_State* L) {
+    check_context(L);
 
-        glBindFramebuffer    (GL_FRAMEBUFFER, 0u);
-        lua_pushlightuserdata(L, framebuffer);
-
-        return 1;
-    } else {
-        printf("Error (%s): Failed to create framebuffer.\n", __func__);
+    flush_batch(&batch);
+    glFinish   ();
 
-        return 0;
-    }
+    return 0;
 }
 
-static int delete_framebuffer(lua_State* L) {
-    Framebuffer* framebuffer = lua_touserdata(L, 1);
+static int set_delay_tolerance(lua_State* L) {
+    const GLdouble tolerance = luaL_checknumber(L, 1);
 
-    if (framebuffer != NULL) {
-        glDeleteRenderbuffers(1, &(framebuffer->RBO));
-        glDeleteTextures     (1, &(framebuffer->texture));
-        glDeleteFramebuffers (1, &(framebuffer->FBO));
-        free                 (framebuffer);
-    }
+    if (tolerance >= 0.0) delay_tolerance = tolerance;
 
     return 0;
 }
 
-static int enable_framebuffer(lua_State* L) {
-    Framebuffer* framebuffer = lua_touserdata(L, 1);
+static int set_vsync(lua_State* L) {
+    check_context(L);
 
-    if (framebuffer != NULL) {
-        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->FBO);
-        glEnable         (GL_DEPTH_TEST);
-        glClear          (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glClearColor     (0.0f, 1.0f, 0.0f, 1.0f);
-    }
+    Window*    window  = check_handle(L, 1, HANDLE_WINDOW);
+    const bool enabled = lua_toboolean (L, 2);
+
+    if (window != NULL && window->window != NULL) glfwSwapInterval(enabled ? 1 : 0);
 
     return 0;
 }
 
-static int disable_framebuffer(lua_State* L) {
-    Framebuffer*   framebuffer = lua_touserdata        (L, 1);
-    const GLclampf red         = (GLclampf)lua_tonumber(L, 2);
-    const GLclampf green       = (GLclampf)lua_tonumber(L, 3);
-    const GLclampf blue        = (GLclampf)lua_tonumber(L, 4);
+static int run(lua_State* L) {
+    check_context(L);
 
-    if (framebuffer != NULL) {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0u);
-        glDisable        (GL_DEPTH_TEST);
-        glClearColor     (red, green, blue, 1.0f);
-        glClear          (GL_COLOR_BUFFER_BIT);
-    }
+    Window*        window     = check_handle     (L, 1, HANDLE_WINDOW);
+    const GLdouble tick_rate  = luaL_checknumber (L, 4);
+    const GLdouble frame_rate = luaL_optnumber   (L, 5, 0.0);
 
-    return 0;
-}
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    luaL_checktype(L, 3, LUA_TFUNCTION);
 
-static int use_framebuffer(lua_State* L) {
-    Framebuffer* framebuffer = lua_touserdata(L, 1);
+    if (window != NULL && window->window != NULL && tick_rate > 0.0) {
+        const GLdouble dt          = 1.0 / tick_rate;
+        GLdouble       accumulator = 0.0;
+        GLdouble       last_time   = monotonic_time();
 
-    if (framebuffer != NULL) {
-        lua_pushlightuserdata(L, &(framebuffer->texture));
+        while (!glfwWindowShouldClose(window->window)) {
+            const GLdouble frame_start = monotonic_time();
+            GLdouble       frame_time  = frame_start - last_time;
 
-        return 1;
-    } else {
-        return 0;
-    }
-}
+            if (frame_time > MAX_FRAME_TIME) frame_time = MAX_FRAME_TIME;
 
-static int create_shader(lua_State* L) {
-    const GLchar* vertex_path   = luaL_checkstring(L, 1);
-    const GLchar* fragment_path = luaL_checkstring(L, 2);
-    GLuint*       shader        = malloc          (sizeof(GLuint));
+            last_time    = frame_start;
+            accumulator += frame_time;
 
-    if (shader != NULL) {
-        *shader = glCreateProgram();
+            GLint ticks = (GLint)(accumulator / dt);
+            GLint tick  = 0;
 
-        GLuint vertex   = compile_vertex_shader  (vertex_path);
-        GLuint fragment = compile_fragment_shader(fragment_path);
+            accumulator -= ticks * dt;
 
-        glAttachShader(*shader, vertex);
-        glAttachShader(*shader, fragment);
-        glLinkProgram (*shader);
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+            glfwPollEvents();
 
-        lua_pushlightuserdata(L, shader);
+            if (!snapshot_input(&input, &ticks)) break;
 
-        return 1;
+            begin_profile_scope(&profiler, "update");
+
+            for (tick = 0; tick < ticks; tick++) {
+                lua_pushvalue (L, 2);
+                lua_pushnumber(L, dt);
+                lua_call      (L, 1, 0);
+                advance_input (&input);
+            }
+
+            end_profile_scope  (&profiler);
+            begin_profile_scope(&profiler, "render");
+            lua_pushvalue      (L, 3);
+            lua_pushnumber     (L, accumulator / dt);
+            lua_call           (L, 1, 0);
+            end_profile_scope  (&profiler);
+
+            begin_profile_pass (&profiler, "present");
+            flush_batch        (&batch);
+            upload_textures    (&texture_cache, texture_cache.budget);
+            end_profile_scope  (&profiler);
+            begin_profile_scope(&profiler, "swap");
+            glfwSwapBuffers    (window->window);
+            end_profile_scope  (&profiler);
+            end_view_frame     (&view);
+            end_profile_frame  (&profiler, L);
+
+            if (frame_rate > 0.0 && input.mode != INPUT_REPLAYING) wait_until(frame_start + 1.0 / frame_rate);
+        }
     }
 
     return 0;
 }
 
-static int delete_shader(lua_State* L) {
-    GLuint* shader = lua_touserdata(L, 1);
+static int run_threaded(lua_State* L) {
+    check_context(L);
 
-    if (shader != NULL) {
-        glDeleteProgram(*shader);
-        free           (shader);
+    Window*        window     = check_handle     (L, 1, HANDLE_WINDOW);
+    const GLdouble tick_rate  = luaL_checknumber (L, 4);
+    const GLdouble frame_rate = luaL_optnumber   (L, 5, 0.0);
+
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    luaL_checktype(L, 3, LUA_TFUNCTION);
+
+    if (window != NULL && window->window != NULL && tick_rate > 0.0 && start_renderer(&renderer, window)) {
+        const GLdouble dt          = 1.0 / tick_rate;
+        GLdouble       accumulator = 0.0;
+        GLdouble       last_time   = monotonic_time();
+
+        while (!glfwWindowShouldClose(window->window)) {
+            const GLdouble frame_start = monotonic_time();
+            GLdouble       frame_time  = frame_start - last_time;
+
+            if (frame_time > MAX_FRAME_TIME) frame_time = MAX_FRAME_TIME;
+
+            last_time    = frame_start;
+            accumulator += frame_time;
+
+            GLint ticks  = (GLint)(accumulator / dt);
+            GLint tick   = 0;
+            GLint status = LUA_OK;
+
+            accumulator -= ticks * dt;
+
+            glfwPollEvents();
+
+            if (!snapshot_input(&input, &ticks)) break;
+
+            begin_profile_scope(&profiler, "update");
+
+            for (tick = 0; tick < ticks && status == LUA_OK; tick++) {
+                lua_pushvalue (L, 2);
+                lua_pushnumber(L, dt);
+
+                status = lua_pcall(L, 1, 0, 0);
+
+                advance_input(&input);
+            }
+
+            end_profile_scope(&profiler);
+
+            if (status == LUA_OK) {
+                recording = &(renderer.lists[renderer.writing]);
+
+                begin_profile_scope(&profiler, "record");
+                lua_pushvalue      (L, 3);
+                lua_pushnumber     (L, accumulator / dt);
+
+                status = lua_pcall(L, 1, 0, 0);
+
+                if (status == LUA_OK) flush_batch(&batch);
+
+                end_profile_scope(&profiler);
+
+                recording = NULL;
+            }
+
+            if (status != LUA_OK) {
+                batch.count = 0;
+
+                stop_renderer(&renderer);
+
+                return lua_error(L);
+            }
+
+            publish_commands (&renderer, frame_rate <= 0.0);
+            drain_retired    (&renderer);
+            end_view_frame   (&view);
+            end_profile_frame(&profiler, L);
+
+            if (frame_rate > 0.0 && input.mode != INPUT_REPLAYING) wait_until(frame_start + 1.0 / frame_rate);
+        }
+
+        stop_renderer(&renderer);
     }
 
     return 0;
 }
 
-static int load_texture(lua_State* L) {
-    const GLchar* texture_path = luaL_checkstring(L, 1);
-    GLuint*       texture      = malloc          (sizeof(GLuint));
+static int get_resource_stats(lua_State* L) {
+    size_t i = 0;
 
-    if (texture != NULL) {
-        glGenTextures  (1, texture);
-        glBindTexture  (GL_TEXTURE_2D, *texture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    lua_createtable(L, 0, RESOURCE_TYPES + 2);
 
-        stbi_set_flip_vertically_on_load(true);
+    for (i = 0; i < RESOURCE_TYPES; i++) {
+        const ResourcePool* pool = &(resources[i]);
 
-        GLint    width    = 0;
-        GLint    height   = 0;
-        GLint    channels = 0;
-        GLubyte* pixels   = stbi_load(texture_path, &width, &height, &channels, 0);
+        lua_createtable(L, 0, 4);
+        lua_pushinteger(L, pool->live);
+        lua_setfield   (L, -2, "live");
+        lua_pushinteger(L, pool->peak);
+        lua_setfield   (L, -2, "peak");
+        lua_pushinteger(L, (lua_Integer)(pool->slab_count * pool->slots * pool->stride));
+        lua_setfield   (L, -2, "cpu_bytes");
+        lua_pushinteger(L, (lua_Integer)pool->gpu_bytes);
+        lua_setfield   (L, -2, "gpu_bytes");
+        lua_setfield   (L, -2, pool->name);
+    }
 
-        if (pixels != NULL) {
-            glTexImage2D    (GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
-            glGenerateMipmap(GL_TEXTURE_2D);
-        } else {
-            printf("Error (%s): Failed to load texture file: %s.\n.", __func__, texture_path);
-        }
+    lua_createtable(L, 0, 1);
+    lua_pushinteger(L, mesh_pool.count - mesh_pool.free_count);
+    lua_setfield   (L, -2, "live");
+    lua_setfield   (L, -2, "mesh");
+    lua_createtable(L, 0, 1);
+    lua_pushinteger(L, entities.count - entities.free_count);
+    lua_setfield   (L, -2, "live");
+    lua_setfield   (L, -2, "entity");
+
+    return 1;
+}
+
+static int get_render_stats(lua_State* L) {
+    pthread_mutex_lock(&(renderer.mutex));
+
+    lua_pushinteger(L, renderer.submitted);
+    lua_pushinteger(L, renderer.rendered);
+    lua_pushinteger(L, renderer.dropped);
 
-        stbi_image_free      (pixels);
-        lua_pushlightuserdata(L, texture);
+    pthread_mutex_unlock(&(renderer.mutex));
+
+    return 3;
+}
+
+static int get_key(lua_State* L) {
+    Window* window    = check_handle     (L, 1, HANDLE_WINDOW);
+    const   GLint key = luaL_checkinteger(L, 2);
+
+    if (window != NULL && window->window != NULL) {
+        lua_pushboolean(L, key_down(input.current, key));
 
         return 1;
     }
@@ -476,35 +1814,25 @@ static int load_texture(lua_State* L) {
     return 0;
 }
 
-static int delete_texture(lua_State* L) {
-    GLuint* texture = lua_touserdata(L, 1);
+static int key_pressed(lua_State* L) {
+    Window* window    = check_handle     (L, 1, HANDLE_WINDOW);
+    const   GLint key = luaL_checkinteger(L, 2);
 
-    if (texture != NULL) {
-        glDeleteTextures(1, texture);
-        free            (texture);
+    if (window != NULL && window->window != NULL) {
+        lua_pushboolean(L, key_down(input.current, key) && !key_down(input.previous, key));
+
+        return 1;
     }
 
     return 0;
 }
 
-static int create_mesh(lua_State* L) {
-    Mesh* mesh = malloc(sizeof(Mesh));
-
-    if (mesh != NULL) {
-        mesh->scale.v[0]        = 1.0f;
-        mesh->scale.v[1]        = 1.0f;
-        mesh->angle_of_rotation = 0.0f;
-        mesh->position.v[0]     = 0.0f;
-        mesh->position.v[1]     = 0.0f;
-        mesh->position.v[2]     = 0.0f;
-
-        glGenVertexArrays    (1, &(mesh->VAO));
-        glGenBuffers         (1, &(mesh->VBO));
-        glGenBuffers         (1, &(mesh->EBO));
-        glBindVertexArray    (mesh->VAO);
-        setup_VBO            (&(mesh->VBO));
-        setup_EBO            (&(mesh->EBO));
-        lua_pushlightuserdata(L, mesh);
+static int key_released(lua_State* L) {
+    Window* window    = check_handle     (L, 1, HANDLE_WINDOW);
+    const   GLint key = luaL_checkinteger(L, 2);
+
+    if (window != NULL && window->window != NULL) {
+        lua_pushboolean(L, !key_down(input.current, key) && key_down(input.previous, key));
 
         return 1;
     }
@@ -512,278 +1840,5916 @@ static int create_mesh(lua_State* L) {
     return 0;
 }
 
-static int delete_mesh(lua_State* L) {
-    Mesh* mesh = lua_touserdata(L, 1);
+static int get_input_events(lua_State* L) {
+    static const GLchar* actions[] = {"release", "press", "repeat"};
+    GLint                i         = 0;
+
+    lua_createtable(L, input.event_count, 0);
 
-    if (mesh != NULL) {
-        glDeleteVertexArrays(1, &(mesh->VAO));
-        glDeleteBuffers     (1, &(mesh->VBO));
-        glDeleteBuffers     (1, &(mesh->EBO));
-        free                (mesh);
+    for (i = 0; i < input.event_count; i++) {
+        lua_createtable(L, 0, 2);
+        lua_pushinteger(L, input.events[i].key);
+        lua_setfield   (L, -2, "key");
+        lua_pushstring (L, actions[input.events[i].action]);
+        lua_setfield   (L, -2, "action");
+        lua_rawseti    (L, -2, i + 1);
     }
 
-    return 0;
+    return 1;
 }
 
-static int draw(lua_State* L) {
-    Mesh*         mesh    = lua_touserdata           (L, 1);
-    Window*       window  = lua_touserdata           (L, 2);
-    GLuint*       shader  = lua_touserdata           (L, 3);
-    GLuint*       texture = lua_touserdata           (L, 4);
-    const GLfloat u       = (GLfloat)luaL_checknumber(L, 5);
-    const GLfloat v       = (GLfloat)luaL_checknumber(L, 6);
-    const GLfloat du      = (GLfloat)luaL_checknumber(L, 7);
-    const GLfloat dv      = (GLfloat)luaL_checknumber(L, 8);
-
-    Vec4 TexCoords = {
-        .v = {
-            u, v, du, dv
-        }
-    };
+static int record_input(lua_State* L) {
+    const GLchar*  path      = luaL_checkstring(L, 1);
+    const uint16_t header[2] = { INPUT_VERSION, INPUT_KEYS };
 
-    if (mesh != NULL && window != NULL && shader != NULL && texture != NULL) {
-        Mat4 Model;
+    stop_input(&input);
 
-        identity (&Model);
-        scale    (&Model, mesh->scale.v[0], mesh->scale.v[1], 1.0f);
-        rotate   (&Model, (M_PI * mesh->angle_of_rotation) / 180.0f);
-        translate(&Model, mesh->position.v[0], mesh->position.v[1], mesh->position.v[2]);
+    input.file = fopen(path, "wb");
 
-        const GLfloat aspect  = (GLfloat)window->width / (GLfloat)window->height;
-        const Mat4 Projection = ortho(-aspect, aspect, -1.0f, 1.0f, -10.0f, 10.0f);
+    if (input.file == NULL) {
+        printf("Error (%s): Could not open \"%s\".\n", __func__, path);
 
-        glUseProgram      (*shader);
-        glUniformMatrix4fv(glGetUniformLocation(*shader, "Model"),      1, false, (const GLfloat*)&Model);
-        glUniformMatrix4fv(glGetUniformLocation(*shader, "Projection"), 1, false, (const GLfloat*)&Projection);
-        glUniform4fv      (glGetUniformLocation(*shader, "TexCoords"),  1,        (const GLfloat*)&TexCoords);
-        glBindTexture     (GL_TEXTURE_2D, *texture);
-        glBindVertexArray (mesh->VAO);
-        glDrawElements    (GL_TRIANGLES, 6, GL_UNSIGNED_INT, (GLvoid*)0);
+        return 0;
     }
 
-    return 0;
+    fwrite(INPUT_MAGIC,   1,                4,           input.file);
+    fwrite(header,        sizeof(uint16_t), 2,           input.file);
+    fwrite(input.current, sizeof(uint32_t), INPUT_WORDS, input.file);
+
+    input.mode  = INPUT_RECORDING;
+    input.frame = 0u;
+
+    lua_pushboolean(L, true);
+
+    return 1;
 }
 
-static int set_position(lua_State* L) {
-    Mesh*         mesh = lua_touserdata           (L, 1);
-    const GLfloat x    = (GLfloat)luaL_checknumber(L, 2);
-    const GLfloat y    = (GLfloat)luaL_checknumber(L, 3);
-    const GLfloat z    = (GLfloat)luaL_checknumber(L, 4);
+static int replay_input(lua_State* L) {
+    const GLchar* path = luaL_checkstring(L, 1);
+    GLchar        magic[4];
+    uint16_t      header[2];
+
+    stop_input(&input);
+
+    input.file = fopen(path, "rb");
+
+    if (input.file == NULL) {
+        printf("Error (%s): Could not open \"%s\".\n", __func__, path);
 
-    if (mesh != NULL) {
-        mesh->position.v[0] = x;
-        mesh->position.v[1] = y;
-        mesh->position.v[2] = z;
+        return 0;
     }
 
-    return 0;
-}
+    if (fread(magic,         1,                4,           input.file) != 4 || memcmp(magic, INPUT_MAGIC, 4) != 0 ||
+        fread(header,        sizeof(uint16_t), 2,           input.file) != 2 || header[0] != INPUT_VERSION || header[1] != INPUT_KEYS ||
+        fread(input.current, sizeof(uint32_t), INPUT_WORDS, input.file) != INPUT_WORDS) {
+        printf("Error (%s): \"%s\" is not a compatible input recording.\n", __func__, path);
+        fclose(input.file);
+        memset(input.current, 0, sizeof(input.current));
 
-static int set_scale(lua_State* L) {
-    Mesh*         mesh = lua_touserdata           (L, 1);
-    const GLfloat w    = (GLfloat)luaL_checknumber(L, 2);
-    const GLfloat h    = (GLfloat)luaL_checknumber(L, 3);
+        input.file = NULL;
 
-    if (mesh != NULL) {
-        mesh->scale.v[0] = w;
-        mesh->scale.v[1] = h;
+        return 0;
     }
 
-    return 0;
+    memcpy(input.previous, input.current, sizeof(input.current));
+
+    input.mode        = INPUT_REPLAYING;
+    input.frame       = 0u;
+    input.event_count = 0;
+
+    lua_pushboolean(L, true);
+
+    return 1;
 }
 
-static int set_rotate(lua_State* L) {
-    Mesh*         mesh  = lua_touserdata           (L, 1);
-    const GLfloat angle = (GLfloat)luaL_checknumber(L, 2);
+static int stop_input_lua(lua_State* L) {
+    lua_pushinteger(L, input.frame);
 
-    if (mesh != NULL) mesh->angle_of_rotation = angle;
+    stop_input(&input);
+
+    return 1;
+}
+
+static int get_system_info(lua_State* L) {
+    check_context(L);
+
+    printf("SYSTEM:                   %s\n", OS);
+    printf("VENDOR:                   %s\n", glGetString(GL_VENDOR));
+    printf("RENDERER:                 %s\n", glGetString(GL_RENDERER));
+    printf("VERSION:                  %s\n", glGetString(GL_VERSION));
+    printf("SHADING LANGUAGE VERSION: %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
 
     return 0;
 }
 
-static int create_noise(lua_State* L) {
-    const int  seed  = luaL_checkinteger(L, 1);
-    fnl_state* noise = malloc           (sizeof(fnl_state));
+static int create_framebuffer(lua_State* L) {
+    check_context(L);
 
-    if (noise != NULL) {
-        *noise = fnlCreateState();
+    Window* window = check_handle(L, 1, HANDLE_WINDOW);
+
+    if (window == NULL || window->window == NULL) return 0;
+
+    const GLint width  = (GLint)luaL_optinteger(L, 2, window->width);
+    const GLint height = (GLint)luaL_optinteger(L, 3, window->height);
 
-        noise->noise_type = FNL_NOISE_OPENSIMPLEX2;
-        noise->seed       = seed;
+    if (width < 1 || height < 1) return luaL_error(L, "framebuffer size must be positive");
 
-        lua_pushlightuserdata(L, noise);
+    Framebuffer* framebuffer = alloc_resource(&(resources[RESOURCE_FRAMEBUFFER]));
+
+    if (framebuffer != NULL) {
+        framebuffer->window_width  = window->width;
+        framebuffer->window_height = window->height;
+        framebuffer->filter        = (width == window->width && height == window->height) ? GL_LINEAR : GL_NEAREST;
+        framebuffer->target_scale  = 1.0f;
+        framebuffer->min_scale     = 1.0f;
+
+        glGenFramebuffers        (1, &(framebuffer->FBO));
+        glBindFramebuffer        (GL_FRAMEBUFFER, framebuffer->FBO);
+        glGenTextures            (1, &(framebuffer->texture.ID));
+        bind_texture             (framebuffer->texture.ID);
+        glTexImage2D             (GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri          (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, framebuffer->filter);
+        glTexParameteri          (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, framebuffer->filter);
+        glFramebufferTexture2D   (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, framebuffer->texture.ID, 0);
+        glGenRenderbuffers       (1, &(framebuffer->RBO));
+        glBindRenderbuffer       (GL_RENDERBUFFER, framebuffer->RBO);
+        glRenderbufferStorage    (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, framebuffer->RBO);
+
+        framebuffer->texture.width  = width;
+        framebuffer->texture.height = height;
+        framebuffer->texture.shared = true;
+
+        set_render_scale  (framebuffer, 1.0f);
+        set_resource_bytes(&(resources[RESOURCE_FRAMEBUFFER]), framebuffer, (uint64_t)width * height * 8u);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            printf("Error (%s): Framebuffer is not complete.\n", __func__);
+        }
+
+        glBindFramebuffer (GL_FRAMEBUFFER, 0u);
+        push_resource     (L, RESOURCE_FRAMEBUFFER, framebuffer, framebuffer, HANDLE_FRAMEBUFFER);
+        push_resource     (L, RESOURCE_FRAMEBUFFER, framebuffer, &(framebuffer->texture), HANDLE_TEXTURE);
+        lua_pushvalue     (L, -2);
+        lua_setiuservalue (L, -2, 1);
+        lua_setiuservalue (L, -2, 1);
 
         return 1;
+    } else {
+        printf("Error (%s): Failed to create framebuffer.\n", __func__);
+
+        return 0;
     }
+}
+
+static int delete_framebuffer(lua_State* L) {
+    Framebuffer* framebuffer = take_handle(L, 1, HANDLE_FRAMEBUFFER);
+
+    if (framebuffer != NULL) retire_resource(&renderer, free_framebuffer, framebuffer);
 
     return 0;
 }
 
-static int get_noise(lua_State* L) {
-    fnl_state*  noise = lua_touserdata   (L, 1);
-    const GLint x     = luaL_checkinteger(L, 2);
-    const GLint y     = luaL_checkinteger(L, 3);
+static int enable_framebuffer(lua_State* L) {
+    Framebuffer*   framebuffer = check_handle            (L, 1, HANDLE_FRAMEBUFFER);
+    const GLclampf red         = (GLclampf)luaL_optnumber(L, 2, 0.0);
+    const GLclampf green       = (GLclampf)luaL_optnumber(L, 3, 0.0);
+    const GLclampf blue        = (GLclampf)luaL_optnumber(L, 4, 0.0);
+    const GLclampf alpha       = (GLclampf)luaL_optnumber(L, 5, 0.0);
+    const Vec4     color       = { .v = { red, green, blue, alpha } };
 
-    if (noise != NULL) {
-        lua_pushnumber(L, (float)fnlGetNoise2D(noise, x, y));
+    if (framebuffer != NULL) {
+        flush_batch(&batch);
 
-        return 1;
+        if (recording != NULL) {
+            apply_resolution(framebuffer);
+
+            RenderCommand* command = push_command(recording, COMMAND_BIND_FRAMEBUFFER);
+
+            if (command != NULL) {
+                command->target   = framebuffer;
+                command->values   = color;
+                command->range[0] = framebuffer->render_width;
+                command->range[1] = framebuffer->render_height;
+                command->range[2] = framebuffer->budget > 0.0;
+            }
+        } else {
+            update_resolution(framebuffer);
+            apply_resolution (framebuffer);
+            bind_framebuffer (framebuffer, &color, framebuffer->render_width, framebuffer->render_height, framebuffer->budget > 0.0);
+        }
     }
 
     return 0;
 }
 
-static int delete_noise(lua_State* L) {
-    fnl_state* noise = lua_touserdata(L, 1);
+static int disable_framebuffer(lua_State* L) {
+    Framebuffer*   framebuffer = check_handle          (L, 1, HANDLE_FRAMEBUFFER);
+    const GLclampf red         = (GLclampf)lua_tonumber(L, 2);
+    const GLclampf green       = (GLclampf)lua_tonumber(L, 3);
+    const GLclampf blue        = (GLclampf)lua_tonumber(L, 4);
+
+    if (framebuffer != NULL) {
+        flush_batch(&batch);
 
-    if (noise != NULL) free(noise);
+        if (recording != NULL) {
+            RenderCommand* command = push_command(recording, COMMAND_UNBIND_FRAMEBUFFER);
+
+            if (command != NULL) {
+                command->target = framebuffer;
+                command->values = (Vec4){ .v = { red, green, blue, 1.0f } };
+            }
+        } else {
+            unbind_framebuffer(framebuffer, red, green, blue);
+        }
+    }
 
     return 0;
 }
 
-static int engine(lua_State* L) {
-    luaL_newlib(L, functions);
+static int use_framebuffer(lua_State* L) {
+    Framebuffer* framebuffer = check_handle(L, 1, HANDLE_FRAMEBUFFER);
 
-    return 1;
+    if (framebuffer != NULL) {
+        lua_getiuservalue(L, 1, 1);
+
+        return 1;
+    } else {
+        return 0;
+    }
 }
 
-GLvoid set_window_icon(GLFWwindow* window, const char* icon_path) {
-    if (window != NULL) {
-        GLFWimage icon_image;
+static int present_framebuffer_lua(lua_State* L) {
+    Framebuffer*   framebuffer = check_handle          (L, 1, HANDLE_FRAMEBUFFER);
+    const GLclampf red         = (GLclampf)lua_tonumber(L, 2);
+    const GLclampf green       = (GLclampf)lua_tonumber(L, 3);
+    const GLclampf blue        = (GLclampf)lua_tonumber(L, 4);
 
-        icon_image.pixels = stbi_load(icon_path, &icon_image.width, &icon_image.height, 0, 4);
+    if (framebuffer != NULL) {
+        flush_batch(&batch);
 
-        if (icon_image.pixels != NULL) {
-            glfwSetWindowIcon(window, 1, &icon_image);
-            stbi_image_free  (icon_image.pixels);
+        if (recording != NULL) {
+            RenderCommand* command = push_command(recording, COMMAND_PRESENT_FRAMEBUFFER);
+
+            if (command != NULL) {
+                command->target   = framebuffer;
+                command->values   = (Vec4){ .v = { red, green, blue, 1.0f } };
+                command->range[0] = framebuffer->render_width;
+                command->range[1] = framebuffer->render_height;
+            }
         } else {
-            printf("Error (%s): Failed to open icon file: %s.\n", __func__, icon_path);
+            present_framebuffer(framebuffer, framebuffer->render_width, framebuffer->render_height, red, green, blue);
         }
     }
+
+    return 0;
 }
 
-char* read_file(const char* file_path) {
-    FILE* file      = fopen(file_path, "rb");
-    char* file_data = "";
+static int set_dynamic_resolution(lua_State* L) {
+    Framebuffer*   framebuffer = check_handle           (L, 1, HANDLE_FRAMEBUFFER);
+    const GLdouble budget      = luaL_optnumber         (L, 2, 0.0);
+    const GLfloat  min_scale   = (GLfloat)luaL_optnumber(L, 3, 0.5);
 
-    if(file != NULL) {
-        fseek(file, 0L, SEEK_END);
+    if (framebuffer != NULL) {
+        pthread_mutex_lock(&(renderer.mutex));
 
-        const long file_size = ftell(file);
+        framebuffer->budget    = (budget > 0.0) ? budget : 0.0;
+        framebuffer->min_scale = (min_scale < 0.1f) ? 0.1f : (min_scale > 1.0f) ? 1.0f : min_scale;
+        framebuffer->gpu_time  = 0.0;
+        framebuffer->cooldown  = 0;
 
-        fclose(file);
+        if (budget <= 0.0) framebuffer->target_scale = 1.0f;
 
-        file = fopen(file_path, "r");
+        pthread_mutex_unlock(&(renderer.mutex));
 
-        file_data = memset(malloc(file_size), '\0', file_size + 1);
+        if (budget <= 0.0) set_render_scale(framebuffer, 1.0f);
+    }
 
-        fread (file_data, 1, file_size, file);
-        fclose(file);
-    } else {
-        printf("Error (%s): File not found: %s.\n", __func__, file_path);
+    return 0;
+}
+
+static int get_resolution(lua_State* L) {
+    Framebuffer* framebuffer = check_handle(L, 1, HANDLE_FRAMEBUFFER);
+
+    if (framebuffer != NULL) {
+        pthread_mutex_lock(&(renderer.mutex));
+
+        const GLdouble gpu_time = framebuffer->gpu_time;
+
+        pthread_mutex_unlock(&(renderer.mutex));
+
+        lua_pushinteger(L, framebuffer->render_width);
+        lua_pushinteger(L, framebuffer->render_height);
+        lua_pushnumber (L, framebuffer->scale);
+        lua_pushnumber (L, gpu_time);
+
+        return 4;
     }
 
-    return file_data;
+    return 0;
 }
 
-GLuint compile_vertex_shader(const GLchar* vertex_path) {
-    const char* vertex_shader_source = read_file(vertex_path);
+static int create_shader(lua_State* L) {
+    check_context(L);
+
+    const GLchar* vertex_path   = luaL_checkstring(L, 1);
+    const GLchar* fragment_path = luaL_checkstring(L, 2);
+    Shader*       shader        = alloc_resource  (&(resources[RESOURCE_SHADER]));
+
+    if (shader != NULL) {
+        GLchar*       vertex_data     = NULL;
+        GLchar*       fragment_data   = NULL;
+        const GLchar* vertex_source   = shader_source(vertex_path,   &vertex_data);
+        const GLchar* fragment_source = shader_source(fragment_path, &fragment_data);
+
+        shader->program = 0u;
+
+        if (vertex_source != NULL && fragment_source != NULL) {
+            const uint64_t key = program_key(vertex_source, fragment_source);
+            GLchar         cache_path[256];
 
-    if (vertex_shader_source != NULL) {
-        GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-        GLint success = 0;
+            program_cache_path(cache_path, sizeof(cache_path), vertex_path, fragment_path);
 
-        glShaderSource (vertex, 1, &vertex_shader_source, NULL);
-        glCompileShader(vertex);
-        glGetShaderiv  (vertex, GL_COMPILE_STATUS, &success);
+            shader->program = load_program_binary(cache_path, key);
+
+            if (shader->program == 0u) {
+                shader->program = build_program(vertex_source, fragment_source, vertex_path, fragment_path);
+
+                if (shader->program != 0u) save_program_binary(shader->program, cache_path, key);
+            }
+        }
 
-        if (success == 0) {
-            GLchar info_log [512];
+        free(vertex_data);
+        free(fragment_data);
 
-            glGetShaderInfoLog(vertex, 512, NULL, info_log);
-            printf            ("Error (%s): %s\n", __func__, info_log);
+        if (shader->program == 0u) {
+            free_resource(&(resources[RESOURCE_SHADER]), shader);
 
-            return 0u;
+            return 0;
         }
 
-        return vertex;
+        shader->Projection = glGetUniformLocation(shader->program, "Projection");
+        shader->Sampler    = glGetUniformLocation(shader->program, "Sampler");
+        shader->aspect     = 0.0f;
+        shader->view       = 0u;
+
+        use_program(shader->program);
+        glUniform1i(shader->Sampler, 0);
+
+        push_resource(L, RESOURCE_SHADER, shader, shader, HANDLE_SHADER);
+
+        return 1;
     }
 
-    return 0u;
+    return 0;
 }
 
-GLuint compile_fragment_shader(const GLchar* fragment_path) {
-    const GLchar* fragment_shader_source = read_file(fragment_path);
+static int delete_shader(lua_State* L) {
+    Shader* shader = take_handle(L, 1, HANDLE_SHADER);
 
-    if (fragment_shader_source != NULL) {
-        GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        GLint success   = 0;
+    if (shader != NULL) retire_resource(&renderer, free_shader, shader);
 
-        glShaderSource (fragment, 1, &fragment_shader_source, NULL);
-        glCompileShader(fragment);
-        glGetShaderiv  (fragment, GL_COMPILE_STATUS, &success);
+    return 0;
+}
 
-        if (success == 0) {
-            GLchar info_log [512];
+static int load_texture(lua_State* L) {
+    check_context(L);
 
-            glGetShaderInfoLog(fragment, 512, NULL, info_log);
-            printf            ("Error (%s): %s\n", __func__, info_log);
+    const GLchar* texture_path = luaL_checkstring(L, 1);
+    Texture*      texture      = acquire_texture (&texture_cache, texture_path, false);
 
-            return 0u;
-        }
+    if (texture != NULL) {
+        finish_texture(&texture_cache, texture);
+        push_resource (L, RESOURCE_TEXTURE, texture, texture, HANDLE_TEXTURE);
 
-        return fragment;
+        return 1;
     }
 
-    return 0u;
+    return 0;
 }
 
-GLvoid setup_VBO(GLuint* VBO) {
-    GLfloat* vertice = malloc(4 * 4 * sizeof(GLfloat));
-
-    if (vertice != NULL) {
-        vertice[ 0] = -1.0f;
-        vertice[ 1] =  1.0f;
-        vertice[ 2] =  0.0f;
-        vertice[ 3] =  1.0f;
-        vertice[ 4] = -1.0f;
-        vertice[ 5] = -1.0f;
-        vertice[ 6] =  0.0f;
-        vertice[ 7] =  0.0f;
-        vertice[ 8] =  1.0f;
-        vertice[ 9] = -1.0f;
-        vertice[10] =  1.0f;
-        vertice[11] =  0.0f;
-        vertice[12] =  1.0f;
-        vertice[13] =  1.0f;
-        vertice[14] =  1.0f;
-        vertice[15] =  1.0f;
-
-        glBindBuffer             (GL_ARRAY_BUFFER, *VBO);
-        glBufferData             (GL_ARRAY_BUFFER, 4 * 4 * sizeof(GLfloat), vertice, GL_STATIC_DRAW);
-        glVertexAttribPointer    (0, 2, GL_FLOAT, false, 4 * sizeof(GLfloat), (void*)(0 * sizeof(GLfloat)));
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer    (1, 2, GL_FLOAT, false, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
-        glEnableVertexAttribArray(1);
-        free                     (vertice);
+static int delete_texture(lua_State* L) {
+    Texture* texture = take_handle(L, 1, HANDLE_TEXTURE);
+
+    if (texture != NULL && !texture->shared) retire_resource(&renderer, free_texture, texture);
+
+    return 0;
+}
+
+static int load_texture_async(lua_State* L) {
+    check_context(L);
+
+    const GLchar* texture_path = luaL_checkstring(L, 1);
+    Texture*      texture      = acquire_texture (&texture_cache, texture_path, true);
+
+    if (texture != NULL) {
+        push_resource(L, RESOURCE_TEXTURE, texture, texture, HANDLE_TEXTURE);
+
+        return 1;
     }
+
+    return 0;
 }
 
-GLvoid setup_EBO(GLuint* EBO) {
-    GLuint* indices = malloc(2 * 3 * sizeof(GLuint));
+static int texture_ready(lua_State* L) {
+    Texture* texture = check_handle(L, 1, HANDLE_TEXTURE);
 
-    if (indices != NULL) {
-        indices[0] = 0u;
-        indices[1] = 1u;
-        indices[2] = 3u;
-        indices[3] = 1u;
-        indices[4] = 2u;
-        indices[5] = 3u;
+    if (texture != NULL) {
+        lua_pushboolean(L, texture->shared || texture->state == TEXTURE_READY);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, 2 * 3 * sizeof(GLuint), indices, GL_STATIC_DRAW);
-        free        (indices);
+        return 1;
     }
+
+    return 0;
+}
+
+static int texture_opaque(lua_State* L) {
+    Texture* texture = check_handle(L, 1, HANDLE_TEXTURE);
+
+    if (texture != NULL) {
+        lua_pushboolean(L, texture->opaque && (texture->shared || texture->state == TEXTURE_READY));
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int set_upload_budget(lua_State* L) {
+    const GLdouble budget = luaL_checknumber(L, 1);
+
+    if (budget >= 0.0) texture_cache.budget = budget;
+
+    return 0;
+}
+
+static int create_atlas(lua_State* L) {
+    check_context(L);
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    const GLint padding     = (GLint)luaL_optinteger(L, 2, 1);
+    const GLint page_size   = (GLint)luaL_optinteger(L, 3, ATLAS_PAGE_SIZE);
+    const GLint image_count = (GLint)luaL_len       (L, 1);
+    GLint       i           = 0;
+    GLint       j           = 0;
+
+    luaL_argcheck(L, padding >= 0,  2, "padding must not be negative");
+    luaL_argcheck(L, page_size > 0, 3, "page size must be positive");
+
+    for (i = 0; i < image_count; i++) {
+        lua_geti        (L, 1, i + 1);
+        luaL_checkstring(L, -1);
+        lua_pop         (L, 1);
+    }
+
+    Atlas*      atlas    = alloc_resource(&(resources[RESOURCE_ATLAS]));
+    AtlasImage* images   = calloc        (image_count, sizeof(AtlasImage));
+    AtlasPage*  pages    = calloc        (image_count, sizeof(AtlasPage));
+    Texture*    textures = calloc        (image_count, sizeof(Texture));
+    GLuint*     page_IDs = calloc        (image_count, sizeof(GLuint));
+
+    if (atlas == NULL || images == NULL || pages == NULL || textures == NULL || page_IDs == NULL || image_count == 0) {
+        printf       ("Error (%s): Failed to create atlas.\n", __func__);
+        free_resource(&(resources[RESOURCE_ATLAS]), atlas);
+        free  (images);
+        free  (pages);
+        free  (textures);
+        free  (page_IDs);
+
+        return 0;
+    }
+
+    atlas->page_count    = 0;
+    atlas->texture_count = image_count;
+    atlas->textures      = textures;
+    atlas->pages         = page_IDs;
+
+    stbi_set_flip_vertically_on_load(true);
+
+    for (i = 0; i < image_count; i++) {
+        lua_geti(L, 1, i + 1);
+
+        const GLchar*    image_path = lua_tostring   (L, -1);
+        const PackEntry* entry      = find_pack_entry(&pack, image_path, PACK_TEXTURE);
+
+        if (entry != NULL && entry->channels == TEXTURE_CHANNELS) {
+            images[i].pixels = (GLubyte*)&(pack.data[entry->offset]);
+            images[i].mapped = true;
+            images[i].width  = entry->width;
+            images[i].height = entry->height;
+            images[i].opaque = opaque_pixels(images[i].pixels, (size_t)entry->width * entry->height);
+        } else {
+            images[i].pixels = load_pixels(image_path, &(images[i].width), &(images[i].height), &(images[i].opaque));
+        }
+
+        images[i].index  = i;
+        images[i].page   = -1;
+
+        if (images[i].pixels == NULL) printf("Error (%s): Failed to load texture file: %s.\n", __func__, image_path);
+
+        lua_pop(L, 1);
+    }
+
+    qsort(images, image_count, sizeof(AtlasImage), compare_heights);
+
+    for (i = 0; i < image_count; i++) {
+        AtlasImage* image  = &(images[i]);
+        const GLint width  = image->width  + 2 * padding;
+        const GLint height = image->height + 2 * padding;
+
+        if (image->pixels == NULL) continue;
+
+        for (j = 0; j < atlas->page_count; j++) {
+            if (skyline_insert(&(pages[j]), width, height, &(image->x), &(image->y))) break;
+        }
+
+        if (j == atlas->page_count) {
+            AtlasPage* page = &(pages[atlas->page_count++]);
+
+            page->width      = (width  > page_size) ? width  : page_size;
+            page->height     = (height > page_size) ? height : page_size;
+            page->pixels     = calloc(page->width * page->height, TEXTURE_CHANNELS);
+            page->skyline    = malloc((page->width + 1) * sizeof(SkylineNode));
+            page->node_count = 1;
+
+            if (page->pixels == NULL || page->skyline == NULL) {
+                printf("Error (%s): Failed to allocate atlas page.\n", __func__);
+
+                continue;
+            }
+
+            page->skyline[0] = (SkylineNode){ 0, 0, page->width };
+
+            skyline_insert(page, width, height, &(image->x), &(image->y));
+        }
+
+        image->page = j;
+
+        blit_padded(&(pages[j]), image, padding);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (j = 0; j < atlas->page_count; j++) {
+        glGenTextures  (1, &(atlas->pages[j]));
+        bind_texture   (atlas->pages[j]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D   (GL_TEXTURE_2D, 0, GL_RGBA8, pages[j].width, pages[j].height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pages[j].pixels);
+        free           (pages[j].pixels);
+        free           (pages[j].skyline);
+
+        render_state.uploads++;
+    }
+
+    uint64_t page_bytes = 0u;
+
+    for (j = 0; j < atlas->page_count; j++) {
+        page_bytes += (uint64_t)pages[j].width * pages[j].height * TEXTURE_CHANNELS;
+    }
+
+    set_resource_bytes(&(resources[RESOURCE_ATLAS]), atlas, page_bytes);
+    push_resource     (L, RESOURCE_ATLAS, atlas, atlas, HANDLE_ATLAS);
+    lua_createtable   (L, image_count, 0);
+
+    for (i = 0; i < image_count; i++) {
+        Texture*   texture = &(atlas->textures[images[i].index]);
+        AtlasPage* page    = (images[i].page >= 0) ? &(pages[images[i].page]) : NULL;
+
+        texture->shared = true;
+        texture->opaque = images[i].opaque;
+
+        if (page != NULL) {
+            texture->ID        = atlas->pages[images[i].page];
+            texture->rect.v[0] = (GLfloat)(images[i].x + padding) / (GLfloat)page->width;
+            texture->rect.v[1] = (GLfloat)(images[i].y + padding) / (GLfloat)page->height;
+            texture->rect.v[2] = (GLfloat)images[i].width         / (GLfloat)page->width;
+            texture->rect.v[3] = (GLfloat)images[i].height        / (GLfloat)page->height;
+        }
+
+        if (!images[i].mapped) stbi_image_free(images[i].pixels);
+    }
+
+    for (i = 0; i < image_count; i++) {
+        push_resource    (L, RESOURCE_ATLAS, atlas, &(atlas->textures[i]), HANDLE_TEXTURE);
+        lua_pushvalue    (L, -3);
+        lua_setiuservalue(L, -2, 1);
+        lua_seti         (L, -2, i + 1);
+    }
+
+    free(images);
+    free(pages);
+
+    return 2;
+}
+
+static int delete_atlas(lua_State* L) {
+    Atlas* atlas = take_handle(L, 1, HANDLE_ATLAS);
+
+    if (atlas != NULL) retire_resource(&renderer, free_atlas, atlas);
+
+    return 0;
+}
+
+static int create_mesh(lua_State* L) {
+    const GLuint index = alloc_mesh(&mesh_pool);
+
+    if (index != mesh_pool.capacity) {
+        mesh_pool.position_x     [index] = 0.0f;
+        mesh_pool.position_y     [index] = 0.0f;
+        mesh_pool.position_z     [index] = 0.0f;
+        mesh_pool.scale_x        [index] = 1.0f;
+        mesh_pool.scale_y        [index] = 1.0f;
+        mesh_pool.cosine         [index] = 1.0f;
+        mesh_pool.sine           [index] = 0.0f;
+        mesh_pool.parents        [index] = 0u;
+        mesh_pool.versions       [index] = 0u;
+        mesh_pool.parent_versions[index] = 0u;
+        mesh_pool.resolved       [index] = 0u;
+        mesh_pool.dirty          [index] = 0u;
+
+        mark_mesh_dirty(&mesh_pool, index);
+
+        push_handle (L, (GLvoid*)(uintptr_t)(index + 1u), HANDLE_MESH);
+        lua_getfield(L, LUA_REGISTRYINDEX, MESH_REGISTRY);
+        lua_pushvalue(L, -2);
+        lua_seti    (L, -2, (lua_Integer)index + 1);
+        lua_pop     (L, 1);
+
+        return 1;
+    }
+
+    printf("Error (%s): Failed to allocate mesh.\n", __func__);
+
+    return 0;
+}
+
+static int delete_mesh(lua_State* L) {
+    const GLuint index = get_mesh(&mesh_pool, take_handle(L, 1, HANDLE_MESH));
+
+    if (index != mesh_pool.capacity) free_mesh(&mesh_pool, index);
+
+    return 0;
+}
+
+static int draw(lua_State* L) {
+    const GLuint  index   = get_mesh                 (&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+    Window*       window  = check_handle             (L, 2, HANDLE_WINDOW);
+    Shader*       shader  = check_handle             (L, 3, HANDLE_SHADER);
+    Texture*      texture = check_handle             (L, 4, HANDLE_TEXTURE);
+    const GLfloat u       = (GLfloat)luaL_checknumber(L, 5);
+    const GLfloat v       = (GLfloat)luaL_checknumber(L, 6);
+    const GLfloat du      = (GLfloat)luaL_checknumber(L, 7);
+    const GLfloat dv      = (GLfloat)luaL_checknumber(L, 8);
+
+    if (index != mesh_pool.capacity && window != NULL && shader != NULL && texture != NULL && batch.instances != NULL) {
+        const GLfloat aspect = (GLfloat)window->width / (GLfloat)window->height;
+        const Mat4*   model  = mesh_model(&mesh_pool, index);
+
+        update_view(&view, aspect);
+
+        if (cull_model(&view, model)) return 0;
+
+        Instance* instance = push_instance(&batch, shader, texture->ID, aspect);
+
+        instance->Model = *model;
+
+        instance->TexCoords.v[0] = texture->rect.v[0] + u * du * texture->rect.v[2];
+        instance->TexCoords.v[1] = texture->rect.v[1] + v * dv * texture->rect.v[3];
+        instance->TexCoords.v[2] = du * texture->rect.v[2];
+        instance->TexCoords.v[3] = dv * texture->rect.v[3];
+
+        if (!batch.active) flush_batch(&batch);
+    }
+
+    return 0;
+}
+
+static int begin_batch(lua_State* L) {
+    flush_batch(&batch);
+
+    batch.active     = true;
+    batch.draw_calls = 0u;
+
+    return 0;
+}
+
+static int end_batch(lua_State* L) {
+    flush_batch(&batch);
+
+    batch.active = false;
+
+    lua_pushinteger(L, batch.draw_calls);
+
+    return 1;
+}
+
+static int get_state_changes(lua_State* L) {
+    const RenderState state = read_render_state(&renderer);
+
+    lua_pushinteger(L, state.issued);
+    lua_pushinteger(L, state.skipped);
+
+    return 2;
+}
+
+static int set_sort_mode(lua_State* L) {
+    static const GLchar* modes[] = {"none", "state", "z", "y", NULL};
+
+    const SortMode mode = (SortMode)luaL_checkoption(L, 1, "none", modes);
+
+    if (mode != render_queue.mode) {
+        flush_batch(&batch);
+
+        render_queue.mode = mode;
+    }
+
+    return 0;
+}
+
+static int set_layer(lua_State* L) {
+    const lua_Integer layer = luaL_checkinteger(L, 1);
+
+    luaL_argcheck(L, layer >= 0 && layer <= 255, 1, "layer must be between 0 and 255");
+
+    render_queue.layer = (GLubyte)layer;
+
+    return 0;
+}
+
+static int get_sort_stats(lua_State* L) {
+    lua_pushinteger(L, render_queue.submitted);
+    lua_pushinteger(L, render_queue.changes_before);
+    lua_pushinteger(L, render_queue.changes_after);
+
+    return 3;
+}
+
+static int set_position(lua_State* L) {
+    const GLuint  index = get_mesh                 (&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+    const GLfloat x     = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y     = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat z     = (GLfloat)luaL_checknumber(L, 4);
+
+    if (index != mesh_pool.capacity) {
+        if (mesh_pool.position_x[index] != x || mesh_pool.position_y[index] != y || mesh_pool.position_z[index] != z) {
+            mesh_pool.position_x[index] = x;
+            mesh_pool.position_y[index] = y;
+            mesh_pool.position_z[index] = z;
+
+            mark_mesh_dirty(&mesh_pool, index);
+        }
+    }
+
+    return 0;
+}
+
+static int set_scale(lua_State* L) {
+    const GLuint  index = get_mesh                 (&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+    const GLfloat w     = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat h     = (GLfloat)luaL_checknumber(L, 3);
+
+    if (index != mesh_pool.capacity) {
+        if (mesh_pool.scale_x[index] != w || mesh_pool.scale_y[index] != h) {
+            mesh_pool.scale_x[index] = w;
+            mesh_pool.scale_y[index] = h;
+
+            mark_mesh_dirty(&mesh_pool, index);
+        }
+    }
+
+    return 0;
+}
+
+static int set_rotate(lua_State* L) {
+    const GLuint  index = get_mesh                 (&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+    const GLfloat angle = (GLfloat)luaL_checknumber(L, 2);
+
+    if (index != mesh_pool.capacity) {
+        const GLfloat radians = ((GLfloat)M_PI * angle) / 180.0f;
+
+        mesh_pool.cosine[index] = cosf(radians);
+        mesh_pool.sine  [index] = sinf(radians);
+
+        mark_mesh_dirty(&mesh_pool, index);
+    }
+
+    return 0;
+}
+
+static int set_parent(lua_State* L) {
+    const GLuint index  = get_mesh(&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+    const GLuint parent = lua_isnoneornil(L, 2) ? mesh_pool.capacity : get_mesh(&mesh_pool, check_handle(L, 2, HANDLE_MESH));
+    GLuint       link   = parent;
+
+    if (index == mesh_pool.capacity) return 0;
+
+    while (link != mesh_pool.capacity) {
+        if (link == index) return luaL_argerror(L, 2, "parent would create a cycle");
+
+        link = (mesh_pool.parents[link] != 0u) ? mesh_pool.parents[link] - 1u : mesh_pool.capacity;
+    }
+
+    if (mesh_pool.parents[index] != 0u) mesh_pool.child_count--;
+    if (parent != mesh_pool.capacity)   mesh_pool.child_count++;
+
+    mesh_pool.parents        [index] = (parent != mesh_pool.capacity) ? parent + 1u : 0u;
+    mesh_pool.parent_versions[index] = 0u;
+
+    mark_mesh_dirty(&mesh_pool, index);
+
+    return 0;
+}
+
+static int update_transforms_lua(lua_State* L) {
+    lua_pushinteger(L, update_transforms(&mesh_pool));
+
+    return 1;
+}
+
+static int set_collider(lua_State* L) {
+    const GLuint index   = get_mesh(&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+    const bool   enabled = lua_isnone(L, 2) || lua_toboolean(L, 2);
+
+    if (index == mesh_pool.capacity) return 0;
+
+    if (!reserve_colliders(&spatial, mesh_pool.capacity)) return luaL_error(L, "out of memory");
+
+    if (spatial.pending_count == spatial.capacity) update_colliders(&spatial, &mesh_pool);
+
+    if (enabled && spatial.states[index] == COLLIDER_NONE) {
+        spatial.states [index]                   = COLLIDER_PENDING;
+        spatial.pending[spatial.pending_count++] = index;
+        spatial.ranges [index * 4 + 0]           = 1;
+        spatial.ranges [index * 4 + 2]           = 0;
+    } else if (!enabled && spatial.states[index] != COLLIDER_NONE) {
+        remove_collider(&spatial, index);
+
+        spatial.states[index] = COLLIDER_NONE;
+    }
+
+    return 0;
+}
+
+static int set_cell_size(lua_State* L) {
+    const GLfloat cell_size = (GLfloat)luaL_checknumber(L, 1);
+    GLuint        i         = 0;
+
+    luaL_argcheck(L, cell_size > 0.0f, 1, "cell size must be positive");
+
+    update_colliders(&spatial, &mesh_pool);
+
+    for (i = 0; i < spatial.capacity; i++) {
+        if (spatial.states[i] == COLLIDER_ACTIVE) remove_collider(&spatial, i);
+    }
+
+    spatial.cell_size = cell_size;
+
+    for (i = 0; i < spatial.capacity; i++) {
+        if (spatial.states[i] == COLLIDER_ACTIVE) {
+            spatial.ranges[i * 4 + 0] = 1;
+            spatial.ranges[i * 4 + 2] = 0;
+            spatial.states[i]         = COLLIDER_PENDING;
+
+            spatial.pending[spatial.pending_count++] = i;
+        }
+    }
+
+    return 0;
+}
+
+static int query_rect(lua_State* L) {
+    const GLfloat x0   = (GLfloat)luaL_checknumber(L, 1);
+    const GLfloat y0   = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat x1   = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat y1   = (GLfloat)luaL_checknumber(L, 4);
+    const Vec4    area = { .v = { fminf(x0, x1), fminf(y0, y1), fmaxf(x0, x1), fmaxf(y0, y1) } };
+
+    update_colliders(&spatial, &mesh_pool);
+    query_colliders (&spatial, &area, mesh_pool.capacity);
+    push_colliders  (L, &spatial, 5);
+
+    return 1;
+}
+
+static int query_point(lua_State* L) {
+    const GLfloat x    = (GLfloat)luaL_checknumber(L, 1);
+    const GLfloat y    = (GLfloat)luaL_checknumber(L, 2);
+    const Vec4    area = { .v = { x, y, x, y } };
+
+    update_colliders(&spatial, &mesh_pool);
+    query_colliders (&spatial, &area, mesh_pool.capacity);
+    push_colliders  (L, &spatial, 3);
+
+    return 1;
+}
+
+static int overlaps(lua_State* L) {
+    const GLuint index = get_mesh(&mesh_pool, check_handle(L, 1, HANDLE_MESH));
+
+    update_colliders(&spatial, &mesh_pool);
+
+    if (index != mesh_pool.capacity && index < spatial.capacity && spatial.states[index] == COLLIDER_ACTIVE) {
+        const Vec4 area = spatial.bounds[index];
+
+        query_colliders(&spatial, &area, index);
+    } else {
+        spatial.result_count = 0u;
+    }
+
+    push_colliders(L, &spatial, 2);
+
+    return 1;
+}
+
+static int sweep_tilemap(lua_State* L) {
+    Tilemap*      tilemap     = check_handle             (L, 1, HANDLE_TILEMAP);
+    GLfloat       x           = (GLfloat)luaL_checknumber(L, 2);
+    GLfloat       y           = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat half_width  = (GLfloat)luaL_checknumber(L, 4);
+    const GLfloat half_height = (GLfloat)luaL_checknumber(L, 5);
+    const GLfloat dx          = (GLfloat)luaL_checknumber(L, 6);
+    const GLfloat dy          = (GLfloat)luaL_checknumber(L, 7);
+    bool          blocked_x   = false;
+    bool          blocked_y   = false;
+
+    luaL_argcheck(L, isfinite(x) && isfinite(y),                     2, "position must be finite");
+    luaL_argcheck(L, isfinite(half_width) && isfinite(half_height), 4, "extents must be finite");
+    luaL_argcheck(L, isfinite(dx) && isfinite(dy),                   6, "motion must be finite");
+
+    if (tilemap != NULL) {
+        const GLfloat size    = tilemap->sheet.tile_size;
+        const GLfloat epsilon = size * 0.001f;
+        GLint         column  = 0;
+        GLint         row     = 0;
+
+        if (dx != 0.0f) {
+            const GLint first_row = clamp_tile((y - half_height - tilemap->position.v[1]) / size,           tilemap->height);
+            const GLint last_row  = clamp_tile((y + half_height - epsilon - tilemap->position.v[1]) / size, tilemap->height);
+            const GLint from      = clamp_tile(((dx > 0.0f) ? x + half_width - epsilon : x - half_width) / size - tilemap->position.v[0] / size,           tilemap->width);
+            const GLint to        = clamp_tile(((dx > 0.0f) ? x + half_width + dx - epsilon : x - half_width + dx) / size - tilemap->position.v[0] / size, tilemap->width);
+            const GLint step      = (dx > 0.0f) ? 1 : -1;
+
+            x += dx;
+
+            for (column = from + step; column != to + step; column += step) {
+                if (!solid_tiles(tilemap, column, column, first_row, last_row)) continue;
+
+                x         = tilemap->position.v[0] + ((dx > 0.0f) ? column * size - half_width : (column + 1) * size + half_width);
+                blocked_x = true;
+
+                break;
+            }
+        }
+
+        if (dy != 0.0f) {
+            const GLint first_column = clamp_tile((x - half_width - tilemap->position.v[0]) / size,           tilemap->width);
+            const GLint last_column  = clamp_tile((x + half_width - epsilon - tilemap->position.v[0]) / size, tilemap->width);
+            const GLint from         = clamp_tile(((dy > 0.0f) ? y + half_height - epsilon : y - half_height) / size - tilemap->position.v[1] / size,           tilemap->height);
+            const GLint to           = clamp_tile(((dy > 0.0f) ? y + half_height + dy - epsilon : y - half_height + dy) / size - tilemap->position.v[1] / size, tilemap->height);
+            const GLint step         = (dy > 0.0f) ? 1 : -1;
+
+            y += dy;
+
+            for (row = from + step; row != to + step; row += step) {
+                if (!solid_tiles(tilemap, first_column, last_column, row, row)) continue;
+
+                y         = tilemap->position.v[1] + ((dy > 0.0f) ? row * size - half_height : (row + 1) * size + half_height);
+                blocked_y = true;
+
+                break;
+            }
+        }
+    }
+
+    lua_pushnumber (L, x);
+    lua_pushnumber (L, y);
+    lua_pushboolean(L, blocked_x);
+    lua_pushboolean(L, blocked_y);
+
+    return 4;
+}
+
+static int create_tilemap(lua_State* L) {
+    check_context(L);
+
+    const GLint   width     = (GLint)luaL_checkinteger (L, 1);
+    const GLint   height    = (GLint)luaL_checkinteger (L, 2);
+    const GLfloat tile_size = (GLfloat)luaL_checknumber(L, 3);
+    Texture*      texture   = check_handle             (L, 4, HANDLE_TEXTURE);
+    const GLint   columns   = (GLint)luaL_optinteger   (L, 5, 1);
+    const GLint   rows      = (GLint)luaL_optinteger   (L, 6, 1);
+    GLint         i         = 0;
+
+    luaL_argcheck(L, width > 0 && height > 0, 1, "tilemap size must be positive");
+
+    Tilemap* tilemap = alloc_resource(&(resources[RESOURCE_TILEMAP]));
+
+    if (tilemap != NULL && texture != NULL) {
+        tilemap->width         = width;
+        tilemap->height        = height;
+        tilemap->sheet         = (TileSheet){ *(Handle*)lua_touserdata(L, 4), texture->rect, (columns > 0) ? columns : 1, (rows > 0) ? rows : 1, tile_size };
+        tilemap->chunk_columns = (width  + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+        tilemap->chunk_rows    = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+        tilemap->tiles         = calloc((size_t)width * height, sizeof(uint16_t));
+        tilemap->chunks        = calloc((size_t)tilemap->chunk_columns * tilemap->chunk_rows, sizeof(TilemapChunk));
+        tilemap->vertices      = malloc(TILEMAP_CHUNK_TILES * 4 * 4 * sizeof(GLfloat));
+
+        if (tilemap->tiles == NULL || tilemap->chunks == NULL || tilemap->vertices == NULL) {
+            printf       ("Error (%s): Failed to create tilemap.\n", __func__);
+            free         (tilemap->tiles);
+            free         (tilemap->chunks);
+            free         (tilemap->vertices);
+            free_resource(&(resources[RESOURCE_TILEMAP]), tilemap);
+
+            return 0;
+        }
+
+        for (i = 0; i < tilemap->chunk_columns * tilemap->chunk_rows; i++) tilemap->chunks[i].dirty = true;
+
+        tilemap->EBO = create_tile_indices();
+
+        push_resource    (L, RESOURCE_TILEMAP, tilemap, tilemap, HANDLE_TILEMAP);
+        lua_pushvalue    (L, 4);
+        lua_setiuservalue(L, -2, 1);
+
+        return 1;
+    }
+
+    free_resource(&(resources[RESOURCE_TILEMAP]), tilemap);
+
+    return 0;
+}
+
+static int delete_tilemap(lua_State* L) {
+    Tilemap* tilemap = take_handle(L, 1, HANDLE_TILEMAP);
+
+    if (tilemap != NULL) retire_resource(&renderer, free_tilemap, tilemap);
+
+    return 0;
+}
+
+static int set_tile(lua_State* L) {
+    Tilemap*    tilemap = check_handle            (L, 1, HANDLE_TILEMAP);
+    const GLint x       = (GLint)luaL_checkinteger(L, 2);
+    const GLint y       = (GLint)luaL_checkinteger(L, 3);
+    const GLint tile    = (GLint)luaL_checkinteger(L, 4);
+
+    if (tilemap != NULL && x >= 0 && y >= 0 && x < tilemap->width && y < tilemap->height) {
+        uint16_t* slot = &(tilemap->tiles[(size_t)y * tilemap->width + x]);
+
+        if (*slot != (uint16_t)tile) {
+            *slot = (uint16_t)tile;
+
+            tilemap->chunks[(y / TILEMAP_CHUNK_SIZE) * tilemap->chunk_columns + (x / TILEMAP_CHUNK_SIZE)].dirty = true;
+        }
+    }
+
+    return 0;
+}
+
+static int get_tile(lua_State* L) {
+    Tilemap*    tilemap = check_handle            (L, 1, HANDLE_TILEMAP);
+    const GLint x       = (GLint)luaL_checkinteger(L, 2);
+    const GLint y       = (GLint)luaL_checkinteger(L, 3);
+
+    if (tilemap != NULL && x >= 0 && y >= 0 && x < tilemap->width && y < tilemap->height) {
+        lua_pushinteger(L, tilemap->tiles[(size_t)y * tilemap->width + x]);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int set_tilemap_position(lua_State* L) {
+    Tilemap*      tilemap = check_handle             (L, 1, HANDLE_TILEMAP);
+    const GLfloat x       = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y       = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat z       = (GLfloat)luaL_checknumber(L, 4);
+
+    if (tilemap != NULL) {
+        tilemap->position.v[0] = x;
+        tilemap->position.v[1] = y;
+        tilemap->position.v[2] = z;
+    }
+
+    return 0;
+}
+
+static int draw_tilemap(lua_State* L) {
+    Tilemap* tilemap    = check_handle(L, 1, HANDLE_TILEMAP);
+    Window*  window     = check_handle(L, 2, HANDLE_WINDOW);
+    Shader*  shader     = check_handle(L, 3, HANDLE_SHADER);
+    Texture* texture    = (tilemap != NULL) ? handle_pointer(&(tilemap->sheet.texture)) : NULL;
+    GLint    draw_calls = 0;
+
+    if (tilemap != NULL && window != NULL && shader != NULL && texture != NULL) {
+        const GLfloat aspect     = (GLfloat)window->width / (GLfloat)window->height;
+        const GLfloat chunk_size = tilemap->sheet.tile_size * TILEMAP_CHUNK_SIZE;
+        GLint         visible    = 0;
+
+        update_view(&view, aspect);
+
+        GLint first_x = (GLint)floorf((view.bounds.v[0] - tilemap->position.v[0]) / chunk_size);
+        GLint last_x  = (GLint)floorf((view.bounds.v[2] - tilemap->position.v[0]) / chunk_size);
+        GLint first_y = (GLint)floorf((view.bounds.v[1] - tilemap->position.v[1]) / chunk_size);
+        GLint last_y  = (GLint)floorf((view.bounds.v[3] - tilemap->position.v[1]) / chunk_size);
+
+        if (first_x < 0)                      first_x = 0;
+        if (first_y < 0)                      first_y = 0;
+        if (last_x >= tilemap->chunk_columns) last_x  = tilemap->chunk_columns - 1;
+        if (last_y >= tilemap->chunk_rows)    last_y  = tilemap->chunk_rows    - 1;
+
+        if (last_x >= first_x && last_y >= first_y) visible = (last_x - first_x + 1) * (last_y - first_y + 1);
+
+        view.culled += (GLuint)(tilemap->chunk_columns * tilemap->chunk_rows - visible);
+        view.drawn  += (GLuint)visible;
+
+        const GLint range[4] = { first_x, first_y, last_x, last_y };
+
+        if (recording != NULL) {
+            flush_batch          (&batch);
+            record_tilemap_chunks(recording, tilemap, range);
+
+            RenderCommand* command = push_command(recording, COMMAND_TILEMAP);
+
+            if (command != NULL) {
+                command->target     = tilemap;
+                command->shader     = shader;
+                command->texture    = texture->ID;
+                command->projection = camera_projection(view.camera, aspect);
+                command->values     = (Vec4){ .v = { tilemap->position.v[0], tilemap->position.v[1], tilemap->position.v[2], 1.0f } };
+
+                memcpy(command->range, range, sizeof(range));
+            }
+        } else {
+            begin_tile_draw     (shader, aspect, texture, &(tilemap->position), 1.0f);
+            build_tilemap_chunks(tilemap, range);
+
+            draw_calls = draw_tilemap_chunks(tilemap, range);
+
+            render_state.draws += draw_calls;
+        }
+
+        batch.draw_calls += draw_calls;
+    }
+
+    lua_pushinteger(L, draw_calls);
+
+    return 1;
+}
+
+static int create_noise(lua_State* L) {
+    const int seed  = luaL_checkinteger(L, 1);
+    Noise*    noise = alloc_resource   (&(resources[RESOURCE_NOISE]));
+
+    if (noise != NULL) {
+        noise->state = fnlCreateState();
+        noise->warp  = false;
+
+        noise->state.noise_type = FNL_NOISE_OPENSIMPLEX2;
+        noise->state.seed       = seed;
+
+        push_resource(L, RESOURCE_NOISE, noise, noise, HANDLE_NOISE);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int get_noise(lua_State* L) {
+    Noise*        noise = check_handle             (L, 1, HANDLE_NOISE);
+    const GLfloat x     = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y     = (GLfloat)luaL_checknumber(L, 3);
+
+    if (noise != NULL) {
+        lua_pushnumber(L, sample_noise(noise, x, y));
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int delete_noise(lua_State* L) {
+    Noise* noise = take_handle(L, 1, HANDLE_NOISE);
+
+    if (noise != NULL) free_resource(&(resources[RESOURCE_NOISE]), noise);
+
+    return 0;
+}
+
+static int set_noise(lua_State* L) {
+    static const char* const noise_types[] = {
+        "opensimplex2", "opensimplex2s", "cellular", "perlin", "value_cubic", "value", NULL
+    };
+
+    static const char* const fractal_types[] = {
+        "none", "fbm", "ridged", "pingpong", "domain_warp_progressive", "domain_warp_independent", NULL
+    };
+
+    static const char* const domain_warp_types[] = {
+        "opensimplex2", "opensimplex2_reduced", "basicgrid", NULL
+    };
+
+    Noise* noise = check_handle(L, 1, HANDLE_NOISE);
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    if (noise != NULL) {
+        fnl_state* state = &(noise->state);
+
+        if (lua_getfield(L, 2, "seed")               != LUA_TNIL) state->seed               = (int)luaL_checkinteger(L, -1);
+        if (lua_getfield(L, 2, "frequency")          != LUA_TNIL) state->frequency          = (float)luaL_checknumber(L, -1);
+        if (lua_getfield(L, 2, "noise_type")         != LUA_TNIL) state->noise_type         = luaL_checkoption(L, -1, NULL, noise_types);
+        if (lua_getfield(L, 2, "fractal_type")       != LUA_TNIL) state->fractal_type       = luaL_checkoption(L, -1, NULL, fractal_types);
+        if (lua_getfield(L, 2, "octaves")            != LUA_TNIL) state->octaves            = (int)luaL_checkinteger(L, -1);
+        if (lua_getfield(L, 2, "lacunarity")         != LUA_TNIL) state->lacunarity         = (float)luaL_checknumber(L, -1);
+        if (lua_getfield(L, 2, "gain")               != LUA_TNIL) state->gain               = (float)luaL_checknumber(L, -1);
+        if (lua_getfield(L, 2, "weighted_strength")  != LUA_TNIL) state->weighted_strength  = (float)luaL_checknumber(L, -1);
+        if (lua_getfield(L, 2, "ping_pong_strength") != LUA_TNIL) state->ping_pong_strength = (float)luaL_checknumber(L, -1);
+        if (lua_getfield(L, 2, "domain_warp_type")   != LUA_TNIL) state->domain_warp_type   = luaL_checkoption(L, -1, NULL, domain_warp_types);
+        if (lua_getfield(L, 2, "domain_warp_amp")    != LUA_TNIL) state->domain_warp_amp    = (float)luaL_checknumber(L, -1);
+        if (lua_getfield(L, 2, "domain_warp")        != LUA_TNIL) noise->warp               = lua_toboolean(L, -1);
+
+        lua_pop(L, 12);
+    }
+
+    return 0;
+}
+
+static int fill_noise(lua_State* L) {
+    Noise*        noise  = check_handle             (L, 1, HANDLE_NOISE);
+    const GLfloat x      = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y      = (GLfloat)luaL_checknumber(L, 3);
+    const GLint   width  = (GLint)luaL_checkinteger (L, 4);
+    const GLint   height = (GLint)luaL_checkinteger (L, 5);
+    FloatBuffer*  buffer = check_handle             (L, 6, HANDLE_FLOAT_BUFFER);
+    const GLfloat step   = (GLfloat)luaL_optnumber  (L, 7, 1.0);
+
+    if (noise != NULL && buffer != NULL && width > 0 && height > 0) {
+        if ((size_t)width * height > buffer->count) return luaL_argerror(L, 6, "buffer too small for region");
+
+        generate_noise(noise, x, y, step, width, height, buffer->data);
+    }
+
+    return 0;
+}
+
+static int fill_tilemap_noise(lua_State* L) {
+    Noise*        noise   = check_handle             (L, 1, HANDLE_NOISE);
+    Tilemap*      tilemap = check_handle             (L, 2, HANDLE_TILEMAP);
+    const GLfloat x       = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat y       = (GLfloat)luaL_checknumber(L, 4);
+    NoiseLevels   levels;
+    GLint         i       = 0;
+
+    read_noise_levels(L, 5, &levels);
+
+    if (noise != NULL && tilemap != NULL) {
+        const size_t size   = (size_t)tilemap->width * tilemap->height;
+        GLfloat*     values = malloc(size * sizeof(GLfloat));
+
+        if (values == NULL) {
+            printf("Error (%s): Failed to allocate noise field.\n", __func__);
+
+            return 0;
+        }
+
+        generate_noise(noise, x, y, 1.0f, tilemap->width, tilemap->height, values);
+
+        for (i = 0; i < (GLint)size; i++) tilemap->tiles[i] = classify_noise(&levels, values[i]);
+
+        for (i = 0; i < tilemap->chunk_columns * tilemap->chunk_rows; i++) tilemap->chunks[i].dirty = true;
+
+        free(values);
+    }
+
+    return 0;
+}
+
+static int create_float_buffer(lua_State* L) {
+    const lua_Integer count  = luaL_checkinteger(L, 1);
+    FloatBuffer*      buffer = NULL;
+
+    luaL_argcheck(L, count > 0, 1, "buffer size must be positive");
+
+    buffer = alloc_resource(&(resources[RESOURCE_FLOAT_BUFFER]));
+
+    if (buffer != NULL) {
+        buffer->data  = calloc(count, sizeof(GLfloat));
+        buffer->count = (size_t)count;
+
+        if (buffer->data != NULL) {
+            push_resource(L, RESOURCE_FLOAT_BUFFER, buffer, buffer, HANDLE_FLOAT_BUFFER);
+
+            return 1;
+        }
+
+        free_resource(&(resources[RESOURCE_FLOAT_BUFFER]), buffer);
+    }
+
+    printf("Error (%s): Failed to allocate buffer.\n", __func__);
+
+    return 0;
+}
+
+static int delete_float_buffer(lua_State* L) {
+    FloatBuffer* buffer = take_handle(L, 1, HANDLE_FLOAT_BUFFER);
+
+    if (buffer != NULL) {
+        free         (buffer->data);
+        free_resource(&(resources[RESOURCE_FLOAT_BUFFER]), buffer);
+    }
+
+    return 0;
+}
+
+static int get_float(lua_State* L) {
+    FloatBuffer*      buffer = check_handle     (L, 1, HANDLE_FLOAT_BUFFER);
+    const lua_Integer index  = luaL_checkinteger(L, 2);
+
+    if (buffer != NULL && index >= 1 && (size_t)index <= buffer->count) {
+        lua_pushnumber(L, buffer->data[index - 1]);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int set_float(lua_State* L) {
+    FloatBuffer*      buffer = check_handle             (L, 1, HANDLE_FLOAT_BUFFER);
+    const lua_Integer index  = luaL_checkinteger        (L, 2);
+    const GLfloat     value  = (GLfloat)luaL_checknumber(L, 3);
+
+    if (buffer != NULL && index >= 1 && (size_t)index <= buffer->count) buffer->data[index - 1] = value;
+
+    return 0;
+}
+
+static int create_world(lua_State* L) {
+    check_context(L);
+
+    Noise*            noise      = check_handle              (L, 1, HANDLE_NOISE);
+    Texture*          texture    = check_handle              (L, 2, HANDLE_TEXTURE);
+    const GLfloat     tile_size  = (GLfloat)luaL_checknumber (L, 3);
+    const GLint       columns    = (GLint)luaL_checkinteger  (L, 4);
+    const GLint       rows       = (GLint)luaL_checkinteger  (L, 5);
+    const GLint       radius     = (GLint)luaL_optinteger    (L, 7, 2);
+    const lua_Integer memory_cap = luaL_optinteger           (L, 8, 16 * 1024 * 1024);
+    GLint             workers    = processor_count() - 1;
+    GLint             i          = 0;
+    NoiseLevels       levels;
+
+    luaL_argcheck(L, tile_size > 0.0f, 3, "tile size must be positive");
+    luaL_argcheck(L, radius >= 0,      7, "radius must not be negative");
+    luaL_argcheck(L, memory_cap >= 0,  8, "memory cap must not be negative");
+
+    read_noise_levels(L, 6, &levels);
+
+    if (noise == NULL || texture == NULL) return 0;
+
+    World* world = alloc_resource(&(resources[RESOURCE_WORLD]));
+
+    if (world == NULL) {
+        printf("Error (%s): Failed to create world.\n", __func__);
+
+        return 0;
+    }
+
+    world->levels     = levels;
+    world->noise      = *noise;
+    world->sheet      = (TileSheet){ *(Handle*)lua_touserdata(L, 2), texture->rect, (columns > 0) ? columns : 1, (rows > 0) ? rows : 1, tile_size };
+    world->radius     = radius;
+    world->memory_cap = (size_t)memory_cap;
+    world->budget     = 0.002;
+    world->running    = true;
+    world->EBO        = create_tile_indices();
+
+    pthread_mutex_init(&(world->mutex), NULL);
+    pthread_cond_init (&(world->job_ready), NULL);
+
+    if (workers < 1)                 workers = 1;
+    if (workers > MAX_WORLD_THREADS) workers = MAX_WORLD_THREADS;
+
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&(world->workers[world->worker_count]), NULL, stream_world_chunks, world) != 0) {
+            printf("Error (%s): Failed to start world worker.\n", __func__);
+
+            break;
+        }
+
+        world->worker_count++;
+    }
+
+    push_resource    (L, RESOURCE_WORLD, world, world, HANDLE_WORLD);
+    lua_pushvalue    (L, 2);
+    lua_setiuservalue(L, -2, 1);
+
+    return 1;
+}
+
+static int delete_world(lua_State* L) {
+    World* world = take_handle(L, 1, HANDLE_WORLD);
+
+    if (world != NULL) retire_resource(&renderer, free_world, world);
+
+    return 0;
+}
+
+static int update_world(lua_State* L) {
+    check_context(L);
+
+    World*        world = check_handle             (L, 1, HANDLE_WORLD);
+    const GLfloat x     = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y     = (GLfloat)luaL_checknumber(L, 3);
+
+    if (world == NULL) return 0;
+
+    const GLfloat  chunk_size = world->sheet.tile_size * TILEMAP_CHUNK_SIZE;
+    const GLint    focus_x    = (GLint)floorf(x / chunk_size);
+    const GLint    focus_y    = (GLint)floorf(y / chunk_size);
+    const GLint    keep       = world->radius + 2;
+    const GLdouble start      = monotonic_time();
+    WorldChunk*    chunk      = NULL;
+    GLint          uploads    = 0;
+    GLint          ring       = 0;
+    GLint          dx         = 0;
+    GLint          dy         = 0;
+    GLint          i          = 0;
+
+    world->frame++;
+
+    pthread_mutex_lock(&(world->mutex));
+
+    world->focus_x = focus_x;
+    world->focus_y = focus_y;
+
+    for (ring = 0; ring <= world->radius; ring++) {
+        for (dy = -ring; dy <= ring; dy++) {
+            for (dx = -ring; dx <= ring; dx++) {
+                if (abs(dx) != ring && abs(dy) != ring) continue;
+
+                chunk = find_world_chunk(world, focus_x + dx, focus_y + dy);
+
+                if (chunk == NULL) {
+                    chunk = calloc(1, sizeof(WorldChunk));
+
+                    if (chunk == NULL) continue;
+
+                    const GLuint bucket = hash_chunk(focus_x + dx, focus_y + dy);
+
+                    chunk->x           = focus_x + dx;
+                    chunk->y           = focus_y + dy;
+                    chunk->state       = CHUNK_QUEUED;
+                    chunk->queued_time = start;
+                    chunk->next        = world->buckets[bucket];
+                    chunk->next_job    = world->jobs;
+
+                    world->buckets[bucket] = chunk;
+                    world->jobs            = chunk;
+                    world->memory         += sizeof(WorldChunk);
+                }
+
+                chunk->last_used = world->frame;
+            }
+        }
+    }
+
+    pthread_cond_broadcast(&(world->job_ready));
+
+    if (world->worker_count == 0) {
+        while ((chunk = take_world_job(world)) != NULL) {
+            generate_world_chunk(world, chunk);
+
+            chunk->state    = CHUNK_GENERATED;
+            chunk->next_job = world->done;
+            world->done     = chunk;
+        }
+    }
+
+    for (i = 0; i < WORLD_BUCKETS; i++) {
+        WorldChunk* next = NULL;
+
+        for (chunk = world->buckets[i]; chunk != NULL; chunk = next) {
+            next = chunk->next;
+
+            if (abs(chunk->x - focus_x) <= keep && abs(chunk->y - focus_y) <= keep) continue;
+
+            if (chunk->state == CHUNK_QUEUED) {
+                unlink_world_job (world, chunk);
+                evict_world_chunk(world, chunk);
+            } else if (chunk->state == CHUNK_READY) {
+                evict_world_chunk(world, chunk);
+
+                world->evicted++;
+            }
+        }
+    }
+
+    while (world->done != NULL && (uploads == 0 || monotonic_time() - start < world->budget)) {
+        chunk       = world->done;
+        world->done = chunk->next_job;
+
+        uploads++;
+
+        pthread_mutex_unlock(&(world->mutex));
+
+        const GLdouble latency = monotonic_time() - chunk->queued_time;
+
+        world->generated++;
+        world->total_latency += latency;
+
+        if (latency > world->max_latency) world->max_latency = latency;
+
+        if (abs(chunk->x - focus_x) > keep || abs(chunk->y - focus_y) > keep) {
+            evict_world_chunk(world, chunk);
+
+            world->evicted++;
+        } else {
+            if (chunk->quad_count > 0) upload_tile_quads(&(chunk->mesh), world->EBO, chunk->vertices, chunk->quad_count);
+
+            free(chunk->vertices);
+
+            chunk->vertices = NULL;
+            chunk->state    = CHUNK_READY;
+            world->memory  += (size_t)chunk->quad_count * 16 * sizeof(GLfloat);
+            world->cached++;
+        }
+
+        pthread_mutex_lock(&(world->mutex));
+    }
+
+    pthread_mutex_unlock(&(world->mutex));
+
+    if (world->memory > world->memory_cap) {
+        WorldChunk** candidates = malloc(world->cached * sizeof(WorldChunk*));
+        GLint        count      = 0;
+
+        if (candidates != NULL) {
+            for (i = 0; i < WORLD_BUCKETS; i++) {
+                for (chunk = world->buckets[i]; chunk != NULL; chunk = chunk->next) {
+                    if (chunk->state == CHUNK_READY && chunk->last_used != world->frame && count < (GLint)world->cached) candidates[count++] = chunk;
+                }
+            }
+
+            qsort(candidates, count, sizeof(WorldChunk*), compare_last_used);
+
+            for (i = 0; i < count && world->memory > world->memory_cap; i++) {
+                evict_world_chunk(world, candidates[i]);
+
+                world->evicted++;
+            }
+
+            free(candidates);
+        }
+    }
+
+    return 0;
+}
+
+static int draw_world(lua_State* L) {
+    check_context(L);
+
+    World*        world      = check_handle           (L, 1, HANDLE_WORLD);
+    Window*       window     = check_handle           (L, 2, HANDLE_WINDOW);
+    Shader*       shader     = check_handle           (L, 3, HANDLE_SHADER);
+    const GLfloat view_x     = (GLfloat)luaL_optnumber(L, 4, 0.0);
+    const GLfloat view_y     = (GLfloat)luaL_optnumber(L, 5, 0.0);
+    const GLfloat depth      = (GLfloat)luaL_optnumber(L, 6, 0.0);
+    Texture*      texture    = (world != NULL) ? handle_pointer(&(world->sheet.texture)) : NULL;
+    GLint         draw_calls = 0;
+
+    if (world != NULL && window != NULL && shader != NULL && texture != NULL) {
+        const GLfloat aspect     = (GLfloat)window->width / (GLfloat)window->height;
+        const GLfloat chunk_size = world->sheet.tile_size * TILEMAP_CHUNK_SIZE;
+        const Vec3    position   = { .v = { -view_x, -view_y, depth } };
+        GLint         x          = 0;
+        GLint         y          = 0;
+
+        update_view(&view, aspect);
+
+        const GLint first_x = (GLint)floorf((view_x + view.bounds.v[0]) / chunk_size);
+        const GLint last_x  = (GLint)floorf((view_x + view.bounds.v[2]) / chunk_size);
+        const GLint first_y = (GLint)floorf((view_y + view.bounds.v[1]) / chunk_size);
+        const GLint last_y  = (GLint)floorf((view_y + view.bounds.v[3]) / chunk_size);
+
+        begin_tile_draw(shader, aspect, texture, &position, 1.0f);
+
+        for (y = first_y; y <= last_y; y++) {
+            for (x = first_x; x <= last_x; x++) {
+                WorldChunk* chunk = find_world_chunk(world, x, y);
+
+                if (chunk == NULL || chunk->state != CHUNK_READY) continue;
+
+                chunk->last_used = world->frame;
+                view.drawn++;
+
+                if (chunk->mesh.quad_count > 0) {
+                    bind_vertex_array(chunk->mesh.VAO);
+                    glDrawElements   (GL_TRIANGLES, chunk->mesh.quad_count * 6, GL_UNSIGNED_SHORT, (GLvoid*)0);
+
+                    draw_calls++;
+                }
+            }
+        }
+
+        batch.draw_calls   += draw_calls;
+        render_state.draws += draw_calls;
+    }
+
+    lua_pushinteger(L, draw_calls);
+
+    return 1;
+}
+
+static int get_world_stats(lua_State* L) {
+    World* world = check_handle(L, 1, HANDLE_WORLD);
+
+    if (world != NULL) {
+        lua_createtable(L, 0, 6);
+        lua_pushinteger(L, world->generated);
+        lua_setfield   (L, -2, "generated");
+        lua_pushinteger(L, world->cached);
+        lua_setfield   (L, -2, "cached");
+        lua_pushinteger(L, world->evicted);
+        lua_setfield   (L, -2, "evicted");
+        lua_pushinteger(L, (lua_Integer)world->memory);
+        lua_setfield   (L, -2, "memory");
+        lua_pushnumber (L, (world->generated > 0) ? world->total_latency / world->generated : 0.0);
+        lua_setfield   (L, -2, "latency");
+        lua_pushnumber (L, world->max_latency);
+        lua_setfield   (L, -2, "max_latency");
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int create_font(lua_State* L) {
+    check_context(L);
+
+    static const GLchar* const default_layout[] = {
+        "+-/,.<>*|_", "!?@#$%&=:;\"\"''()", "QRSTUVWXYZ", "ABCDEFGHIJKLMNOP", "0123456789", "[]\\~"
+    };
+
+    Texture*    texture = check_handle           (L, 1, HANDLE_TEXTURE);
+    const GLint columns = (GLint)luaL_optinteger (L, 2, 16);
+    const GLint rows    = (GLint)luaL_optinteger (L, 3, 16);
+    GLint       row     = 0;
+    GLint       column  = 0;
+
+    luaL_argcheck(L, columns > 0 && rows > 0, 2, "font grid must be positive");
+
+    if (texture == NULL) return 0;
+
+    Font* font = alloc_resource(&(resources[RESOURCE_FONT]));
+
+    if (font != NULL) {
+        font->tiles    = malloc(TILEMAP_CHUNK_TILES * sizeof(uint16_t));
+        font->vertices = malloc(TILEMAP_CHUNK_TILES * 4 * 4 * sizeof(GLfloat));
+    }
+
+    if (font == NULL || font->tiles == NULL || font->vertices == NULL) {
+        printf("Error (%s): Failed to create font.\n", __func__);
+
+        if (font != NULL) {
+            free         (font->tiles);
+            free         (font->vertices);
+            free_resource(&(resources[RESOURCE_FONT]), font);
+        }
+
+        return 0;
+    }
+
+    font->sheet = (TileSheet){ *(Handle*)lua_touserdata(L, 1), texture->rect, columns, rows, 1.0f };
+    font->EBO   = create_tile_indices();
+
+    const bool  custom    = lua_istable(L, 4);
+    const GLint row_count = custom ? (GLint)luaL_len(L, 4) : (GLint)(sizeof(default_layout) / sizeof(default_layout[0]));
+
+    for (row = 0; row < row_count && row < rows; row++) {
+        const GLchar* layout = custom ? NULL : default_layout[row];
+
+        if (custom) {
+            lua_geti(L, 4, row + 1);
+
+            layout = luaL_checkstring(L, -1);
+        }
+
+        for (column = 0; layout[column] != '\0' && column < columns; column++) {
+            const GLubyte glyph = (GLubyte)layout[column];
+
+            if (glyph < FONT_GLYPHS && font->glyphs[glyph] == 0) font->glyphs[glyph] = (uint16_t)(row * columns + column + 1);
+        }
+
+        if (custom) lua_pop(L, 1);
+    }
+
+    for (column = 'a'; column <= 'z'; column++) {
+        if (font->glyphs[column] == 0) font->glyphs[column] = font->glyphs[column - 'a' + 'A'];
+    }
+
+    push_resource    (L, RESOURCE_FONT, font, font, HANDLE_FONT);
+    lua_pushvalue    (L, 1);
+    lua_setiuservalue(L, -2, 1);
+
+    return 1;
+}
+
+static int delete_font(lua_State* L) {
+    Font* font = take_handle(L, 1, HANDLE_FONT);
+
+    if (font != NULL) retire_resource(&renderer, free_font, font);
+
+    return 0;
+}
+
+static int draw_text(lua_State* L) {
+    Font*         font    = check_handle             (L, 1, HANDLE_FONT);
+    Window*       window  = check_handle             (L, 2, HANDLE_WINDOW);
+    Shader*       shader  = check_handle             (L, 3, HANDLE_SHADER);
+    const GLchar* text    = luaL_checkstring         (L, 4);
+    const GLfloat x       = (GLfloat)luaL_checknumber(L, 5);
+    const GLfloat y       = (GLfloat)luaL_checknumber(L, 6);
+    const GLfloat size    = (GLfloat)luaL_checknumber(L, 7);
+    const GLfloat z       = (GLfloat)luaL_optnumber  (L, 8, 0.0);
+    Texture*      texture = (font != NULL) ? handle_pointer(&(font->sheet.texture)) : NULL;
+
+    if (font != NULL && window != NULL && shader != NULL && texture != NULL) {
+        const GLfloat aspect = (GLfloat)window->width / (GLfloat)window->height;
+        GLint         offset = 0;
+
+        if (recording != NULL) {
+            if (!measure_text(text, NULL, NULL)) return luaL_argerror(L, 4, "text does not fit in one run");
+
+            flush_batch(&batch);
+
+            if (!record_text(recording, text, &offset)) return 0;
+
+            RenderCommand* command = push_command(recording, COMMAND_TEXT);
+
+            if (command != NULL) {
+                command->target     = font;
+                command->shader     = shader;
+                command->texture    = texture->ID;
+                command->projection = camera_projection(view.camera, aspect);
+                command->values     = (Vec4){ .v = { x, y, z, size } };
+                command->range[0]   = offset;
+            }
+
+            return 0;
+        }
+
+        TextRun* run = find_text_run(font, text);
+
+        if (run == NULL) return luaL_argerror(L, 4, "text does not fit in one run");
+
+        if (run->mesh.quad_count > 0) {
+            const Vec3 position = { .v = { x, y, z } };
+
+            begin_tile_draw(shader, aspect, texture, &position, size);
+            draw_text_run  (run);
+
+            batch.draw_calls++;
+            render_state.draws++;
+        }
+    }
+
+    return 0;
+}
+
+static int create_entity(lua_State* L) {
+    const GLuint index = alloc_entity(&entities);
+
+    if (index != entities.capacity) {
+        entities.masks      [index] = ENTITY_ALIVE;
+        entities.position_x [index] = 0.0f;
+        entities.position_y [index] = 0.0f;
+        entities.position_z [index] = 0.0f;
+        entities.scale_x    [index] = 1.0f;
+        entities.scale_y    [index] = 1.0f;
+        entities.cosine     [index] = 1.0f;
+        entities.sine       [index] = 0.0f;
+        entities.velocity_x [index] = 0.0f;
+        entities.velocity_y [index] = 0.0f;
+        entities.textures   [index] = (Handle){ NULL, NULL, 0u };
+        entities.frame_time [index] = 0.0f;
+
+        push_handle(L, (GLvoid*)(uintptr_t)(index + 1u), HANDLE_ENTITY);
+
+        return 1;
+    }
+
+    printf("Error (%s): Failed to allocate entity.\n", __func__);
+
+    return 0;
+}
+
+static int delete_entity(lua_State* L) {
+    const GLuint index = get_entity(&entities, take_handle(L, 1, HANDLE_ENTITY));
+
+    if (index != entities.capacity) free_entity(&entities, index);
+
+    return 0;
+}
+
+static int set_transform(lua_State* L) {
+    const GLuint  index = get_entity               (&entities, check_handle(L, 1, HANDLE_ENTITY));
+    const GLfloat x     = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y     = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat z     = (GLfloat)luaL_optnumber  (L, 4, 0.0);
+    const GLfloat w     = (GLfloat)luaL_optnumber  (L, 5, 1.0);
+    const GLfloat h     = (GLfloat)luaL_optnumber  (L, 6, 1.0);
+    const GLfloat angle = (GLfloat)luaL_optnumber  (L, 7, 0.0);
+
+    if (index != entities.capacity) {
+        const GLfloat radians = ((GLfloat)M_PI * angle) / 180.0f;
+
+        entities.position_x[index] = x;
+        entities.position_y[index] = y;
+        entities.position_z[index] = z;
+        entities.scale_x   [index] = w;
+        entities.scale_y   [index] = h;
+        entities.cosine    [index] = cosf(radians);
+        entities.sine      [index] = sinf(radians);
+        entities.masks     [index] |= COMPONENT_TRANSFORM;
+    }
+
+    return 0;
+}
+
+static int set_velocity(lua_State* L) {
+    const GLuint  index = get_entity               (&entities, check_handle(L, 1, HANDLE_ENTITY));
+    const GLfloat x     = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y     = (GLfloat)luaL_checknumber(L, 3);
+
+    if (index != entities.capacity) {
+        entities.velocity_x[index] = x;
+        entities.velocity_y[index] = y;
+        entities.masks     [index] |= COMPONENT_VELOCITY;
+    }
+
+    return 0;
+}
+
+static int set_sprite(lua_State* L) {
+    const GLuint  index   = get_entity               (&entities, check_handle(L, 1, HANDLE_ENTITY));
+    Texture*      texture = check_handle             (L, 2, HANDLE_TEXTURE);
+    const GLfloat u       = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat v       = (GLfloat)luaL_checknumber(L, 4);
+    const GLfloat du      = (GLfloat)luaL_checknumber(L, 5);
+    const GLfloat dv      = (GLfloat)luaL_checknumber(L, 6);
+
+    if (index != entities.capacity && texture != NULL) {
+        entities.textures[index] = *(Handle*)lua_touserdata(L, 2);
+        entities.cells   [index] = (Vec4){ .v = { u, v, du, dv } };
+        entities.masks   [index] |= COMPONENT_SPRITE;
+
+        lua_pushvalue    (L, 2);
+        lua_setiuservalue(L, 1, 1);
+    }
+
+    return 0;
+}
+
+static int set_animation(lua_State* L) {
+    const GLuint  index = get_entity               (&entities, check_handle(L, 1, HANDLE_ENTITY));
+    const GLfloat first = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat count = (GLfloat)luaL_checknumber(L, 3);
+    const GLfloat rate  = (GLfloat)luaL_checknumber(L, 4);
+
+    luaL_argcheck(L, count >= 1.0f, 3, "animation needs at least one frame");
+
+    if (index != entities.capacity) {
+        entities.first_frame[index] = first;
+        entities.frame_count[index] = count;
+        entities.frame_rate [index] = rate;
+        entities.frame_time [index] = 0.0f;
+        entities.masks      [index] |= COMPONENT_ANIMATION;
+    }
+
+    return 0;
+}
+
+static int remove_component(lua_State* L) {
+    static const char* const components[] = {
+        "transform", "velocity", "sprite", "animation", NULL
+    };
+
+    const GLuint index     = get_entity      (&entities, check_handle(L, 1, HANDLE_ENTITY));
+    const int    component = luaL_checkoption(L, 2, NULL, components);
+
+    if (index != entities.capacity) {
+        entities.masks[index] &= ~(1u << component);
+
+        if (component == 1) {
+            entities.velocity_x[index] = 0.0f;
+            entities.velocity_y[index] = 0.0f;
+        }
+    }
+
+    return 0;
+}
+
+static int get_entity_position(lua_State* L) {
+    const GLuint index = get_entity(&entities, check_handle(L, 1, HANDLE_ENTITY));
+
+    if (index != entities.capacity) {
+        lua_pushnumber(L, entities.position_x[index]);
+        lua_pushnumber(L, entities.position_y[index]);
+        lua_pushnumber(L, entities.position_z[index]);
+
+        return 3;
+    }
+
+    return 0;
+}
+
+static int integrate_entities(lua_State* L) {
+    const GLfloat  dt         = (GLfloat)luaL_checknumber(L, 1);
+    GLfloat*       position_x = entities.position_x;
+    GLfloat*       position_y = entities.position_y;
+    const GLfloat* velocity_x = entities.velocity_x;
+    const GLfloat* velocity_y = entities.velocity_y;
+    GLuint         i          = 0;
+
+    for (i = 0; i < entities.count; i++) {
+        position_x[i] += velocity_x[i] * dt;
+        position_y[i] += velocity_y[i] * dt;
+    }
+
+    return 0;
+}
+
+static int animate_entities(lua_State* L) {
+    const GLfloat dt = (GLfloat)luaL_checknumber(L, 1);
+    GLuint        i  = 0;
+
+    for (i = 0; i < entities.count; i++) {
+        if ((entities.masks[i] & (COMPONENT_ANIMATION | COMPONENT_SPRITE)) != (COMPONENT_ANIMATION | COMPONENT_SPRITE)) continue;
+
+        const GLfloat time  = fmodf(entities.frame_time[i] + dt, entities.frame_count[i] / entities.frame_rate[i]);
+        const GLfloat frame = floorf(time * entities.frame_rate[i]);
+
+        entities.frame_time[i]      = time;
+        entities.cells     [i].v[0] = entities.first_frame[i] + frame;
+    }
+
+    return 0;
+}
+
+static int draw_entities(lua_State* L) {
+    Window* window = check_handle(L, 1, HANDLE_WINDOW);
+    Shader* shader = check_handle(L, 2, HANDLE_SHADER);
+    GLint   drawn  = 0;
+    GLuint  i      = 0;
+
+    if (window != NULL && shader != NULL && batch.instances != NULL) {
+        const GLfloat aspect = (GLfloat)window->width / (GLfloat)window->height;
+
+        update_view(&view, aspect);
+
+        for (i = 0; i < entities.count; i++) {
+            if ((entities.masks[i] & (COMPONENT_TRANSFORM | COMPONENT_SPRITE)) != (COMPONENT_TRANSFORM | COMPONENT_SPRITE)) continue;
+
+            const Mat4 model = { .m = {
+                {  entities.cosine[i] * entities.scale_x[i], entities.sine  [i] * entities.scale_x[i], 0.0f, 0.0f },
+                { -entities.sine  [i] * entities.scale_y[i], entities.cosine[i] * entities.scale_y[i], 0.0f, 0.0f },
+                {  0.0f,                                     0.0f,                                     1.0f, 0.0f },
+                {  entities.position_x[i],                   entities.position_y[i],                   entities.position_z[i], 1.0f }
+            } };
+
+            const Texture* texture = handle_pointer(&(entities.textures[i]));
+
+            if (texture == NULL || cull_model(&view, &model)) continue;
+
+            const Vec4*    cell     = &(entities.cells[i]);
+            Instance*      instance = push_instance(&batch, shader, texture->ID, aspect);
+
+            instance->Model = model;
+
+            instance->TexCoords.v[0] = texture->rect.v[0] + cell->v[0] * cell->v[2] * texture->rect.v[2];
+            instance->TexCoords.v[1] = texture->rect.v[1] + cell->v[1] * cell->v[3] * texture->rect.v[3];
+            instance->TexCoords.v[2] = cell->v[2] * texture->rect.v[2];
+            instance->TexCoords.v[3] = cell->v[3] * texture->rect.v[3];
+
+            drawn++;
+        }
+
+        if (!batch.active) flush_batch(&batch);
+    }
+
+    lua_pushinteger(L, drawn);
+
+    return 1;
+}
+
+static int set_positions(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    const size_t   count = (size_t)luaL_len(L, 1);
+    const GLfloat* data  = check_floats     (L, 2, count * 3);
+    size_t         i     = 0;
+
+    for (i = 0; i < count; i++) {
+        lua_geti(L, 1, (lua_Integer)i + 1);
+
+        const GLuint index = get_mesh(&mesh_pool, check_handle(L, -1, HANDLE_MESH));
+
+        lua_pop(L, 1);
+
+        if (index == mesh_pool.capacity) continue;
+
+        mesh_pool.position_x[index] = data[i * 3 + 0];
+        mesh_pool.position_y[index] = data[i * 3 + 1];
+        mesh_pool.position_z[index] = data[i * 3 + 2];
+
+        mark_mesh_dirty(&mesh_pool, index);
+    }
+
+    return 0;
+}
+
+static int draw_meshes(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    Window*        window  = check_handle    (L, 2, HANDLE_WINDOW);
+    Shader*        shader  = check_handle    (L, 3, HANDLE_SHADER);
+    Texture*       texture = check_handle    (L, 4, HANDLE_TEXTURE);
+    const size_t   count   = (size_t)luaL_len(L, 1);
+    const GLfloat* cells   = check_floats    (L, 5, count * 4);
+    size_t         i       = 0;
+
+    if (window != NULL && shader != NULL && texture != NULL && batch.instances != NULL) {
+        const GLfloat aspect = (GLfloat)window->width / (GLfloat)window->height;
+
+        if (mesh_pool.dirty_count > 0u) update_transforms(&mesh_pool);
+
+        update_view(&view, aspect);
+
+        for (i = 0; i < count; i++) {
+            lua_geti(L, 1, (lua_Integer)i + 1);
+
+            const GLuint index = get_mesh(&mesh_pool, check_handle(L, -1, HANDLE_MESH));
+
+            lua_pop(L, 1);
+
+            if (index == mesh_pool.capacity || cull_model(&view, &(mesh_pool.models[index]))) continue;
+
+            const GLfloat* cell     = &(cells[i * 4]);
+            Instance*      instance = push_instance(&batch, shader, texture->ID, aspect);
+
+            instance->Model          = mesh_pool.models[index];
+            instance->TexCoords.v[0] = texture->rect.v[0] + cell[0] * cell[2] * texture->rect.v[2];
+            instance->TexCoords.v[1] = texture->rect.v[1] + cell[1] * cell[3] * texture->rect.v[3];
+            instance->TexCoords.v[2] = cell[2] * texture->rect.v[2];
+            instance->TexCoords.v[3] = cell[3] * texture->rect.v[3];
+        }
+
+        if (!batch.active) flush_batch(&batch);
+    }
+
+    return 0;
+}
+
+static int create_camera(lua_State* L) {
+    const GLfloat x        = (GLfloat)luaL_optnumber(L, 1, 0.0);
+    const GLfloat y        = (GLfloat)luaL_optnumber(L, 2, 0.0);
+    const GLfloat zoom     = (GLfloat)luaL_optnumber(L, 3, 1.0);
+    const GLfloat rotation = (GLfloat)luaL_optnumber(L, 4, 0.0);
+
+    luaL_argcheck(L, zoom > 0.0f, 3, "zoom must be positive");
+
+    Camera* camera = alloc_resource(&(resources[RESOURCE_CAMERA]));
+
+    if (camera != NULL) {
+        const GLfloat radians = ((GLfloat)M_PI * rotation) / 180.0f;
+
+        camera->position = (Vec2){ .v = { x, y } };
+        camera->zoom     = zoom;
+        camera->cosine   = cosf(radians);
+        camera->sine     = sinf(radians);
+
+        push_resource(L, RESOURCE_CAMERA, camera, camera, HANDLE_CAMERA);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int delete_camera(lua_State* L) {
+    Camera* camera = take_handle(L, 1, HANDLE_CAMERA);
+
+    if (camera != NULL) {
+        if (view.camera == camera) {
+            flush_batch(&batch);
+
+            view.camera = &default_camera;
+            view.version++;
+        }
+
+        free_resource(&(resources[RESOURCE_CAMERA]), camera);
+    }
+
+    return 0;
+}
+
+static int set_camera(lua_State* L) {
+    Camera*       camera = check_handle             (L, 1, HANDLE_CAMERA);
+    const GLfloat x      = (GLfloat)luaL_checknumber(L, 2);
+    const GLfloat y      = (GLfloat)luaL_checknumber(L, 3);
+
+    if (camera != NULL) {
+        const GLfloat zoom = (GLfloat)luaL_optnumber(L, 4, camera->zoom);
+
+        luaL_argcheck(L, zoom > 0.0f, 4, "zoom must be positive");
+
+        if (camera == view.camera) {
+            flush_batch(&batch);
+
+            view.version++;
+        }
+
+        camera->position = (Vec2){ .v = { x, y } };
+        camera->zoom     = zoom;
+
+        if (!lua_isnoneornil(L, 5)) {
+            const GLfloat radians = ((GLfloat)M_PI * (GLfloat)luaL_checknumber(L, 5)) / 180.0f;
+
+            camera->cosine = cosf(radians);
+            camera->sine   = sinf(radians);
+        }
+    }
+
+    return 0;
+}
+
+static int use_camera(lua_State* L) {
+    Camera* camera = lua_isnoneornil(L, 1) ? &default_camera : check_handle(L, 1, HANDLE_CAMERA);
+
+    if (camera != NULL && camera != view.camera) {
+        flush_batch(&batch);
+
+        view.camera = camera;
+        view.version++;
+    }
+
+    return 0;
+}
+
+static int get_cull_stats(lua_State* L) {
+    lua_pushinteger(L, view.last_drawn);
+    lua_pushinteger(L, view.last_culled);
+
+    return 2;
+}
+
+static int begin_scope(lua_State* L) {
+    begin_profile_scope(&profiler, luaL_checkstring(L, 1));
+
+    return 0;
+}
+
+static int end_scope(lua_State* L) {
+    if (profiler.depth == 0) return luaL_error(L, "no profile scope is open");
+
+    end_profile_scope(&profiler);
+
+    return 0;
+}
+
+static int begin_pass(lua_State* L) {
+    begin_profile_pass(&profiler, luaL_checkstring(L, 1));
+
+    return 0;
+}
+
+static int get_frame_stats(lua_State* L) {
+    const ProfileFrame* frame = &(profiler.frames[profiler.current ^ 1]);
+    GLint               i     = 0;
+
+    lua_createtable(L, 0, 7);
+
+    lua_pushnumber (L, frame->frame_time * 1000.0);
+    lua_setfield   (L, -2, "frame_time");
+    lua_pushinteger(L, frame->draw_calls);
+    lua_setfield   (L, -2, "draw_calls");
+    lua_pushinteger(L, frame->state_changes);
+    lua_setfield   (L, -2, "state_changes");
+    lua_pushinteger(L, frame->texture_uploads);
+    lua_setfield   (L, -2, "texture_uploads");
+    lua_pushinteger(L, (lua_Integer)frame->lua_memory);
+    lua_setfield   (L, -2, "lua_memory");
+
+    lua_newtable(L);
+
+    for (i = 0; i < frame->count; i++) {
+        const ProfileScope* scope = &(frame->scopes[i]);
+
+        lua_getfield  (L, -1, scope->name);
+        lua_pushnumber(L, lua_tonumber(L, -1) + scope->duration * 1000.0);
+        lua_setfield  (L, -3, scope->name);
+        lua_pop       (L, 1);
+    }
+
+    lua_setfield(L, -2, "scopes");
+    lua_newtable(L);
+
+    for (i = 0; i < profiler.pass_count; i++) {
+        lua_pushnumber(L, profiler.pass_list[i].time);
+        lua_setfield  (L, -2, profiler.pass_list[i].name);
+    }
+
+    lua_setfield(L, -2, "passes");
+
+    return 1;
+}
+
+static int capture_trace(lua_State* L) {
+    const GLchar* path   = luaL_checkstring (L, 1);
+    const GLint   frames = luaL_optinteger  (L, 2, 60);
+
+    luaL_argcheck(L, frames > 0, 2, "frame count must be positive");
+
+    if (profiler.capture_frames > 0) return luaL_error(L, "a trace capture is already running");
+
+    GLchar* copy = malloc(strlen(path) + 1);
+
+    if (copy == NULL) return 0;
+
+    strcpy(copy, path);
+    free  (profiler.capture_path);
+
+    profiler.capture_path   = copy;
+    profiler.capture_frames = frames;
+    profiler.capture_count  = 0;
+    profiler.capture_origin = monotonic_time();
+
+    return 0;
+}
+
+static int engine(lua_State* L) {
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(handle_types) / sizeof(handle_types[0]); i++) {
+        luaL_newmetatable(L, handle_types[i].name);
+        lua_newtable     (L);
+        luaL_setfuncs    (L, handle_types[i].methods, 0);
+        lua_setfield     (L, -2, "__index");
+        lua_getfield     (L, -1, "__index");
+        lua_getfield     (L, -1, "delete");
+        lua_setfield     (L, -3, "__gc");
+        lua_pop          (L, 2);
+    }
+
+    lua_newtable     (L);
+    lua_newtable     (L);
+    lua_pushliteral  (L, "v");
+    lua_setfield     (L, -2, "__mode");
+    lua_setmetatable (L, -2);
+    lua_setfield     (L, LUA_REGISTRYINDEX, MESH_REGISTRY);
+
+    luaL_newlib(L, functions);
+
+    return 1;
+}
+
+GLvoid push_handle(lua_State* L, GLvoid* pointer, const GLchar* type) {
+    Handle* handle = lua_newuserdatauv(L, sizeof(Handle), 1);
+
+    handle->pointer = pointer;
+    handle->pool    = NULL;
+    handle->id      = 0u;
+
+    luaL_setmetatable(L, type);
+}
+
+GLvoid push_resource(lua_State* L, ResourceType type, GLvoid* owner, GLvoid* pointer, const GLchar* name) {
+    push_handle(L, pointer, name);
+
+    Handle* handle = lua_touserdata(L, -1);
+
+    handle->pool = &(resources[type]);
+    handle->id   = resource_id(owner);
+}
+
+GLvoid* handle_pointer(Handle* handle) {
+    if (handle->pool != NULL && get_resource(handle->pool, handle->id) == NULL) {
+        handle->pointer = NULL;
+        handle->pool    = NULL;
+    }
+
+    return handle->pointer;
+}
+
+GLvoid* check_handle(lua_State* L, int index, const GLchar* type) {
+    Handle* handle = luaL_checkudata(L, index, type);
+
+    return handle_pointer(handle);
+}
+
+GLvoid* take_handle(lua_State* L, int index, const GLchar* type) {
+    Handle* handle  = luaL_checkudata(L, index, type);
+    GLvoid* pointer = handle_pointer(handle);
+
+    handle->pointer = NULL;
+    handle->pool    = NULL;
+
+    return pointer;
+}
+
+GLvoid* alloc_resource(ResourcePool* pool) {
+    GLuint index = 0u;
+
+    if (pool->free_count > 0u) {
+        index = pool->free_list[--pool->free_count];
+    } else {
+        if (pool->count == pool->capacity) {
+            if (pool->stride == 0u) {
+                pool->stride = sizeof(ResourceHeader) + ((pool->size + 15u) & ~(size_t)15u);
+                pool->slots  = (pool->stride < RESOURCE_SLAB_BYTES) ? (GLuint)(RESOURCE_SLAB_BYTES / pool->stride) : 1u;
+            }
+
+            const GLuint capacity = pool->capacity + pool->slots;
+            bool         failed   = false;
+            size_t       i        = 0;
+
+            if (capacity > RESOURCE_INDEX_MASK) return NULL;
+
+            GLubyte* slab = malloc(pool->slots * pool->stride);
+
+            GLvoid** arrays[] = {
+                (GLvoid**)&(pool->slabs), (GLvoid**)&(pool->generations), (GLvoid**)&(pool->free_list)
+            };
+
+            const size_t sizes[] = {
+                (pool->slab_count + 1u) * sizeof(GLubyte*), capacity * sizeof(uint16_t), capacity * sizeof(GLuint)
+            };
+
+            for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                GLvoid* array = realloc(*arrays[i], sizes[i]);
+
+                if (array != NULL) {
+                    *arrays[i] = array;
+                } else {
+                    failed = true;
+                }
+            }
+
+            if (failed || slab == NULL) {
+                free(slab);
+
+                return NULL;
+            }
+
+            memset(&(pool->generations[pool->capacity]), 0, pool->slots * sizeof(uint16_t));
+
+            pool->slabs[pool->slab_count++] = slab;
+            pool->capacity                  = capacity;
+        }
+
+        index = pool->count++;
+    }
+
+    ResourceHeader* header = (ResourceHeader*)&(pool->slabs[index / pool->slots][(index % pool->slots) * pool->stride]);
+
+    memset(header, 0, pool->stride);
+
+    header->id = ((uint32_t)pool->generations[index] << RESOURCE_INDEX_BITS) | (index + 1u);
+
+    if (++pool->live > pool->peak) pool->peak = pool->live;
+
+    return header + 1;
+}
+
+GLvoid free_resource(ResourcePool* pool, GLvoid* pointer) {
+    if (pointer == NULL) return;
+
+    ResourceHeader* header = (ResourceHeader*)pointer - 1;
+    const GLuint    index  = (header->id & RESOURCE_INDEX_MASK) - 1u;
+
+    if (get_resource(pool, header->id) != pointer) {
+        printf("Error (%s): Invalid %s resource.\n", __func__, pool->name);
+
+        return;
+    }
+
+    pool->gpu_bytes          -= header->gpu_bytes;
+    pool->generations[index]  = (pool->generations[index] + 1u) % RESOURCE_GENERATIONS;
+    header->id                = 0u;
+    header->gpu_bytes         = 0u;
+
+    pool->free_list[pool->free_count++] = index;
+    pool->live--;
+}
+
+GLvoid* get_resource(ResourcePool* pool, uint32_t id) {
+    const GLuint index = (id & RESOURCE_INDEX_MASK) - 1u;
+
+    if ((id & RESOURCE_INDEX_MASK) == 0u || index >= pool->count) return NULL;
+
+    ResourceHeader* header = (ResourceHeader*)&(pool->slabs[index / pool->slots][(index % pool->slots) * pool->stride]);
+
+    return (header->id == id) ? header + 1 : NULL;
+}
+
+uint32_t resource_id(const GLvoid* pointer) {
+    return ((const ResourceHeader*)pointer - 1)->id;
+}
+
+GLvoid set_resource_bytes(ResourcePool* pool, GLvoid* pointer, uint64_t gpu_bytes) {
+    ResourceHeader* header = (ResourceHeader*)pointer - 1;
+
+    pool->gpu_bytes   = pool->gpu_bytes - header->gpu_bytes + gpu_bytes;
+    header->gpu_bytes = gpu_bytes;
+}
+
+GLvoid report_resources(GLvoid) {
+    size_t i = 0;
+
+    for (i = 0; i < RESOURCE_TYPES; i++) {
+        const ResourcePool* pool = &(resources[i]);
+
+        if (pool->live > 0u) {
+            printf("Error (%s): %u %s resource(s) not deleted, %llu GPU bytes.\n", __func__, pool->live, pool->name, (unsigned long long)pool->gpu_bytes);
+        }
+    }
+
+    if (mesh_pool.count > mesh_pool.free_count) {
+        printf("Error (%s): %u mesh resource(s) not deleted.\n", __func__, mesh_pool.count - mesh_pool.free_count);
+    }
+
+    if (entities.count > entities.free_count) {
+        printf("Error (%s): %u entity resource(s) not deleted.\n", __func__, entities.count - entities.free_count);
+    }
+}
+
+GLvoid delete_resources(GLvoid) {
+    size_t i = 0;
+    GLuint j = 0;
+
+    for (i = 0; i < RESOURCE_TYPES; i++) {
+        ResourcePool* pool = &(resources[i]);
+
+        for (j = 0; j < pool->slab_count; j++) {
+            free(pool->slabs[j]);
+        }
+
+        free(pool->slabs);
+        free(pool->generations);
+        free(pool->free_list);
+
+        pool->slabs       = NULL;
+        pool->generations = NULL;
+        pool->free_list   = NULL;
+        pool->slab_count  = 0u;
+        pool->count       = 0u;
+        pool->free_count  = 0u;
+        pool->capacity    = 0u;
+        pool->live        = 0u;
+        pool->gpu_bytes   = 0u;
+    }
+}
+
+const GLfloat* check_floats(lua_State* L, int index, size_t count) {
+    Handle* handle = luaL_testudata(L, index, HANDLE_FLOAT_BUFFER);
+    size_t  i      = 0;
+
+    if (handle != NULL) {
+        FloatBuffer* buffer = handle_pointer(handle);
+
+        luaL_argcheck(L, buffer != NULL && buffer->count >= count, index, "buffer too small");
+
+        return buffer->data;
+    }
+
+    luaL_checktype(L, index, LUA_TTABLE);
+    luaL_argcheck (L, (size_t)luaL_len(L, index) >= count, index, "table too small");
+
+    if (scratch_floats.count < count) {
+        GLfloat* data = realloc(scratch_floats.data, count * sizeof(GLfloat));
+
+        if (data == NULL) luaL_error(L, "out of memory");
+
+        scratch_floats.data  = data;
+        scratch_floats.count = count;
+    }
+
+    for (i = 0; i < count; i++) {
+        lua_geti(L, index, (lua_Integer)i + 1);
+
+        scratch_floats.data[i] = (GLfloat)lua_tonumber(L, -1);
+
+        lua_pop(L, 1);
+    }
+
+    return scratch_floats.data;
+}
+
+GLvoid key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (key < 0 || key >= INPUT_KEYS) return;
+
+    if (action == GLFW_PRESS)   input.live[key / 32] |=  (1u << (key % 32));
+    if (action == GLFW_RELEASE) input.live[key / 32] &= ~(1u << (key % 32));
+
+    if (input.pending_count < INPUT_EVENTS) input.pending[input.pending_count++] = (InputEvent){ (uint16_t)key, (uint16_t)action };
+}
+
+bool key_down(const uint32_t* keys, GLint key) {
+    return key >= 0 && key < INPUT_KEYS && (keys[key / 32] & (1u << (key % 32))) != 0u;
+}
+
+bool snapshot_input(Input* input, GLint* ticks) {
+    memcpy(input->snapshot, input->current, sizeof(input->current));
+
+    if (input->mode == INPUT_REPLAYING) {
+        input->pending_count = 0;
+
+        if (read_input_frame(input, ticks)) return true;
+
+        stop_input(input);
+
+        return false;
+    }
+
+    const GLint count = (input->pending_count < INPUT_EVENTS - input->event_count) ? input->pending_count : INPUT_EVENTS - input->event_count;
+
+    memcpy(input->current,                       input->live,    sizeof(input->current));
+    memcpy(&(input->events[input->event_count]), input->pending, count * sizeof(InputEvent));
+
+    input->event_count  += count;
+    input->pending_count = 0;
+
+    if (input->mode == INPUT_RECORDING) write_input_frame(input, (ticks != NULL) ? *ticks : 0);
+
+    return true;
+}
+
+GLvoid advance_input(Input* input) {
+    memcpy(input->previous, input->current, sizeof(input->current));
+
+    input->event_count = 0;
+}
+
+bool read_input_frame(Input* input, GLint* ticks) {
+    uint16_t header[2];
+    uint16_t key = 0;
+    GLint    i   = 0;
+
+    if (fread(header, sizeof(uint16_t), 2, input->file) != 2) return false;
+
+    for (i = 0; i < header[1]; i++) {
+        if (fread(&key, sizeof(uint16_t), 1, input->file) != 1 || key >= INPUT_KEYS) return false;
+
+        input->current[key / 32] ^= (1u << (key % 32));
+
+        if (input->event_count < INPUT_EVENTS) {
+            input->events[input->event_count++] = (InputEvent){ key, key_down(input->current, key) ? GLFW_PRESS : GLFW_RELEASE };
+        }
+    }
+
+    if (ticks != NULL) *ticks = header[0];
+
+    input->frame++;
+
+    return true;
+}
+
+GLvoid write_input_frame(Input* input, GLint ticks) {
+    uint16_t keys[INPUT_KEYS];
+    uint16_t header[2] = { (uint16_t)ticks, 0u };
+    GLint    word      = 0;
+    GLint    bit       = 0;
+
+    for (word = 0; word < INPUT_WORDS; word++) {
+        const uint32_t changed = input->current[word] ^ input->snapshot[word];
+
+        if (changed == 0u) continue;
+
+        for (bit = 0; bit < 32; bit++) {
+            if (changed & (1u << bit)) keys[header[1]++] = (uint16_t)(word * 32 + bit);
+        }
+    }
+
+    fwrite(header, sizeof(uint16_t), 2,         input->file);
+    fwrite(keys,   sizeof(uint16_t), header[1], input->file);
+
+    input->frame++;
+}
+
+GLvoid stop_input(Input* input) {
+    if (input->file != NULL) fclose(input->file);
+
+    input->file = NULL;
+    input->mode = INPUT_LIVE;
+}
+
+GLvoid check_context(lua_State* L) {
+    if (renderer.running) luaL_error(L, "the GL context is owned by the render thread");
+}
+
+RenderCommand* push_command(CommandList* list, CommandType type) {
+    if (list->command_count == list->command_capacity) {
+        const GLsizei  capacity = (list->command_capacity > 0) ? list->command_capacity * 2 : 256;
+        RenderCommand* commands = realloc(list->commands, capacity * sizeof(RenderCommand));
+
+        if (commands == NULL) {
+            printf("Error (%s): Failed to grow the command list.\n", __func__);
+
+            return NULL;
+        }
+
+        list->commands         = commands;
+        list->command_capacity = capacity;
+    }
+
+    RenderCommand* command = &(list->commands[list->command_count++]);
+
+    memset(command, 0, sizeof(RenderCommand));
+
+    command->type = type;
+
+    return command;
+}
+
+GLvoid record_instances(CommandList* list, Batch* batch) {
+    if (list->instance_count + batch->count > list->instance_capacity) {
+        GLsizei   capacity  = (list->instance_capacity > 0) ? list->instance_capacity : MAX_BATCH_INSTANCES;
+        Instance* instances = NULL;
+
+        while (capacity < list->instance_count + batch->count) capacity *= 2;
+
+        instances = realloc(list->instances, capacity * sizeof(Instance));
+
+        if (instances == NULL) {
+            printf("Error (%s): Failed to grow the instance list.\n", __func__);
+
+            return;
+        }
+
+        list->instances         = instances;
+        list->instance_capacity = capacity;
+    }
+
+    RenderCommand* command = push_command(list, COMMAND_INSTANCES);
+
+    if (command == NULL) return;
+
+    memcpy(&(list->instances[list->instance_count]), batch->instances, batch->count * sizeof(Instance));
+
+    command->shader     = batch->shader;
+    command->texture    = batch->texture;
+    command->projection = camera_projection(view.camera, batch->aspect);
+    command->range[0]   = list->instance_count;
+    command->range[1]   = batch->count;
+
+    list->instance_count += batch->count;
+}
+
+bool record_text(CommandList* list, const GLchar* text, GLint* offset) {
+    const size_t length = strlen(text) + 1;
+
+    if (list->text_size + length > list->text_capacity) {
+        size_t  capacity = (list->text_capacity > 0) ? list->text_capacity : 4096;
+        GLchar* buffer   = NULL;
+
+        while (capacity < list->text_size + length) capacity *= 2;
+
+        buffer = realloc(list->text, capacity);
+
+        if (buffer == NULL) {
+            printf("Error (%s): Failed to grow the text buffer.\n", __func__);
+
+            return false;
+        }
+
+        list->text          = buffer;
+        list->text_capacity = capacity;
+    }
+
+    memcpy(&(list->text[list->text_size]), text, length);
+
+    *offset          = (GLint)list->text_size;
+    list->text_size += length;
+
+    return true;
+}
+
+GLfloat* reserve_vertices(CommandList* list, size_t count) {
+    if (list->vertex_count + count > list->vertex_capacity) {
+        size_t   capacity = (list->vertex_capacity > 0) ? list->vertex_capacity : 65536;
+        GLfloat* vertices = NULL;
+
+        while (capacity < list->vertex_count + count) capacity *= 2;
+
+        vertices = realloc(list->vertices, capacity * sizeof(GLfloat));
+
+        if (vertices == NULL) {
+            printf("Error (%s): Failed to grow the vertex buffer.\n", __func__);
+
+            return NULL;
+        }
+
+        list->vertices        = vertices;
+        list->vertex_capacity = capacity;
+    }
+
+    return &(list->vertices[list->vertex_count]);
+}
+
+GLvoid record_tilemap_chunks(CommandList* list, Tilemap* tilemap, const GLint* range) {
+    GLint x = 0;
+    GLint y = 0;
+
+    for (y = range[1]; y <= range[3]; y++) {
+        for (x = range[0]; x <= range[2]; x++) {
+            if (!tilemap->chunks[y * tilemap->chunk_columns + x].dirty) continue;
+
+            GLfloat* vertices = reserve_vertices(list, TILEMAP_CHUNK_TILES * 4 * 4);
+
+            if (vertices == NULL) return;
+
+            RenderCommand* command = push_command(list, COMMAND_TILEMAP_CHUNK);
+
+            if (command == NULL) return;
+
+            command->target   = tilemap;
+            command->range[0] = y * tilemap->chunk_columns + x;
+            command->range[1] = (GLint)list->vertex_count;
+            command->range[2] = fill_chunk(tilemap, x, y, vertices);
+
+            list->vertex_count += (size_t)command->range[2] * 4 * 4;
+        }
+    }
+}
+
+GLvoid execute_commands(CommandList* list) {
+    GLsizei i = 0;
+
+    for (i = 0; i < list->command_count; i++) {
+        const RenderCommand* command  = &(list->commands[i]);
+        const Vec3           position = { .v = { command->values.v[0], command->values.v[1], command->values.v[2] } };
+
+        if (command->type == COMMAND_CLEAR) {
+            clear_screen(command->values.v[0], command->values.v[1], command->values.v[2]);
+        } else if (command->type == COMMAND_BIND_FRAMEBUFFER) {
+            update_resolution(command->target);
+            bind_framebuffer (command->target, &(command->values), command->range[0], command->range[1], command->range[2] != 0);
+        } else if (command->type == COMMAND_UNBIND_FRAMEBUFFER) {
+            unbind_framebuffer(command->target, command->values.v[0], command->values.v[1], command->values.v[2]);
+        } else if (command->type == COMMAND_PRESENT_FRAMEBUFFER) {
+            present_framebuffer(command->target, command->range[0], command->range[1], command->values.v[0], command->values.v[1], command->values.v[2]);
+        } else if (command->type == COMMAND_INSTANCES) {
+            use_program   (command->shader->program);
+            set_projection(command->shader, &(command->projection));
+            draw_instances(&batch, command->texture, &(list->instances[command->range[0]]), command->range[1]);
+
+            render_state.draws++;
+        } else if (command->type == COMMAND_TILEMAP) {
+            Tilemap* tilemap = command->target;
+
+            use_program        (command->shader->program);
+            set_projection     (command->shader, &(command->projection));
+            setup_tile_draw    (command->texture, &position, 1.0f);
+
+            render_state.draws += draw_tilemap_chunks(tilemap, command->range);
+        } else if (command->type == COMMAND_TILEMAP_CHUNK) {
+            Tilemap* tilemap = command->target;
+
+            upload_tile_quads(&(tilemap->chunks[command->range[0]]), tilemap->EBO, &(list->vertices[command->range[1]]), command->range[2]);
+        } else if (command->type == COMMAND_TEXT) {
+            Font*    font = command->target;
+            TextRun* run  = find_text_run(font, &(list->text[command->range[0]]));
+
+            if (run == NULL || run->mesh.quad_count == 0) continue;
+
+            use_program    (command->shader->program);
+            set_projection (command->shader, &(command->projection));
+            setup_tile_draw(command->texture, &position, command->values.v[3]);
+            draw_text_run  (run);
+
+            render_state.draws++;
+        }
+    }
+
+    list->command_count  = 0;
+    list->instance_count = 0;
+    list->text_size      = 0;
+    list->vertex_count   = 0;
+}
+
+bool start_renderer(Renderer* renderer, Window* window) {
+    GLint i = 0;
+
+    flush_batch(&batch);
+
+    for (i = 0; i < RENDER_LISTS; i++) {
+        renderer->lists[i].command_count  = 0;
+        renderer->lists[i].instance_count = 0;
+        renderer->lists[i].text_size      = 0;
+        renderer->lists[i].vertex_count   = 0;
+    }
+
+    renderer->writing   = 0;
+    renderer->ready     = -1;
+    renderer->reading   = -1;
+    renderer->window    = window;
+    renderer->running   = true;
+    renderer->submitted = 0u;
+    renderer->rendered  = 0u;
+    renderer->dropped   = 0u;
+    renderer->stats     = render_state;
+
+    glfwMakeContextCurrent(NULL);
+
+    if (pthread_create(&(renderer->thread), NULL, render_frames, renderer) != 0) {
+        printf                ("Error (%s): Failed to start the render thread.\n", __func__);
+        glfwMakeContextCurrent(window->window);
+
+        renderer->running = false;
+
+        return false;
+    }
+
+    return true;
+}
+
+GLvoid publish_commands(Renderer* renderer, bool wait) {
+    GLint i = 0;
+
+    pthread_mutex_lock(&(renderer->mutex));
+
+    while (wait && renderer->ready >= 0 && renderer->running) pthread_cond_wait(&(renderer->list_taken), &(renderer->mutex));
+
+    if (renderer->ready >= 0) {
+        CommandList* stale = &(renderer->lists[renderer->ready]);
+
+        for (i = 0; i < stale->command_count; i++) {
+            const RenderCommand* command = &(stale->commands[i]);
+
+            if (command->type == COMMAND_TILEMAP_CHUNK) ((Tilemap*)command->target)->chunks[command->range[0]].dirty = true;
+        }
+
+        stale->command_count  = 0;
+        stale->instance_count = 0;
+        stale->text_size      = 0;
+        stale->vertex_count   = 0;
+
+        renderer->dropped++;
+    }
+
+    renderer->ready = renderer->writing;
+
+    for (i = 0; i < RENDER_LISTS; i++) {
+        if (i != renderer->ready && i != renderer->reading) break;
+    }
+
+    renderer->writing = i;
+    renderer->submitted++;
+
+    pthread_cond_signal (&(renderer->list_ready));
+    pthread_mutex_unlock(&(renderer->mutex));
+}
+
+GLvoid stop_renderer(Renderer* renderer) {
+    pthread_mutex_lock    (&(renderer->mutex));
+
+    renderer->running = false;
+
+    pthread_cond_broadcast(&(renderer->list_ready));
+    pthread_cond_broadcast(&(renderer->list_taken));
+    pthread_mutex_unlock  (&(renderer->mutex));
+    pthread_join          (renderer->thread, NULL);
+    glfwMakeContextCurrent(renderer->window->window);
+    free_retired          (renderer);
+
+    renderer->draining = false;
+}
+
+GLvoid* render_frames(GLvoid* argument) {
+    Renderer* renderer = argument;
+
+    glfwMakeContextCurrent(renderer->window->window);
+    pthread_mutex_lock    (&(renderer->mutex));
+
+    while (true) {
+        while (renderer->ready < 0 && !renderer->draining && renderer->running) pthread_cond_wait(&(renderer->list_ready), &(renderer->mutex));
+
+        if (renderer->ready < 0 && renderer->draining) {
+            free_retired(renderer);
+
+            renderer->draining = false;
+
+            pthread_cond_signal(&(renderer->list_taken));
+
+            continue;
+        }
+
+        if (renderer->ready < 0) break;
+
+        renderer->reading = renderer->ready;
+        renderer->ready   = -1;
+
+        pthread_cond_signal (&(renderer->list_taken));
+        pthread_mutex_unlock(&(renderer->mutex));
+
+        execute_commands(&(renderer->lists[renderer->reading]));
+        upload_textures (&texture_cache, texture_cache.budget);
+        glfwSwapBuffers (renderer->window->window);
+
+        pthread_mutex_lock(&(renderer->mutex));
+
+        renderer->rendered++;
+        renderer->stats = render_state;
+    }
+
+    renderer->reading = -1;
+
+    pthread_mutex_unlock  (&(renderer->mutex));
+    glfwMakeContextCurrent(NULL);
+
+    return NULL;
+}
+
+GLvoid delete_renderer(Renderer* renderer) {
+    GLint i = 0;
+
+    for (i = 0; i < RENDER_LISTS; i++) {
+        free(renderer->lists[i].commands);
+        free(renderer->lists[i].instances);
+        free(renderer->lists[i].text);
+        free(renderer->lists[i].vertices);
+
+        memset(&(renderer->lists[i]), 0, sizeof(CommandList));
+    }
+
+    free(renderer->retired);
+
+    renderer->retired          = NULL;
+    renderer->retired_count    = 0;
+    renderer->retired_capacity = 0;
+}
+
+GLvoid retire_resource(Renderer* renderer, GLvoid (*release)(GLvoid*), GLvoid* pointer) {
+    if (!renderer->running) {
+        release(pointer);
+
+        return;
+    }
+
+    if (renderer->retired_count == renderer->retired_capacity) {
+        const GLint      capacity = (renderer->retired_capacity > 0) ? renderer->retired_capacity * 2 : 64;
+        RetiredResource* retired  = realloc(renderer->retired, capacity * sizeof(RetiredResource));
+
+        if (retired == NULL) {
+            printf("Error (%s): Failed to defer a resource release.\n", __func__);
+
+            return;
+        }
+
+        renderer->retired          = retired;
+        renderer->retired_capacity = capacity;
+    }
+
+    renderer->retired[renderer->retired_count++] = (RetiredResource){ release, pointer };
+}
+
+GLvoid drain_retired(Renderer* renderer) {
+    if (renderer->retired_count == 0) return;
+
+    pthread_mutex_lock(&(renderer->mutex));
+
+    renderer->draining = true;
+
+    pthread_cond_signal(&(renderer->list_ready));
+
+    while (renderer->draining && renderer->running) pthread_cond_wait(&(renderer->list_taken), &(renderer->mutex));
+
+    pthread_mutex_unlock(&(renderer->mutex));
+}
+
+RenderState read_render_state(Renderer* renderer) {
+    if (!renderer->running) return render_state;
+
+    pthread_mutex_lock(&(renderer->mutex));
+
+    const RenderState state = renderer->stats;
+
+    pthread_mutex_unlock(&(renderer->mutex));
+
+    return state;
+}
+
+GLvoid free_retired(Renderer* renderer) {
+    GLint i = 0;
+
+    for (i = 0; i < renderer->retired_count; i++) renderer->retired[i].release(renderer->retired[i].pointer);
+
+    renderer->retired_count = 0;
+}
+
+GLvoid free_framebuffer(GLvoid* pointer) {
+    Framebuffer* framebuffer = pointer;
+
+    flush_batch          (&batch);
+    glDeleteRenderbuffers(1, &(framebuffer->RBO));
+    glDeleteTextures     (1, &(framebuffer->texture.ID));
+
+    if (framebuffer->queries[0][0] != 0u) glDeleteQueries(FRAMEBUFFER_QUERIES * 2, &(framebuffer->queries[0][0]));
+
+    if (render_state.texture == framebuffer->texture.ID) render_state.texture = 0u;
+    if (batch.texture == framebuffer->texture.ID)        batch.texture        = 0u;
+
+    glDeleteFramebuffers (1, &(framebuffer->FBO));
+    free_resource        (&(resources[RESOURCE_FRAMEBUFFER]), framebuffer);
+}
+
+GLvoid free_shader(GLvoid* pointer) {
+    Shader* shader = pointer;
+
+    flush_batch    (&batch);
+    glDeleteProgram(shader->program);
+
+    if (render_state.program == shader->program) render_state.program = 0u;
+    if (batch.shader == shader)                  batch.shader         = NULL;
+
+    free_resource(&(resources[RESOURCE_SHADER]), shader);
+}
+
+GLvoid free_atlas(GLvoid* pointer) {
+    Atlas* atlas = pointer;
+    GLint  i     = 0;
+
+    flush_batch(&batch);
+
+    for (i = 0; i < atlas->page_count; i++) {
+        if (render_state.texture == atlas->pages[i]) render_state.texture = 0u;
+        if (batch.texture == atlas->pages[i])        batch.texture        = 0u;
+    }
+
+    glDeleteTextures(atlas->page_count, atlas->pages);
+    free            (atlas->pages);
+    free            (atlas->textures);
+    free_resource   (&(resources[RESOURCE_ATLAS]), atlas);
+}
+
+GLvoid free_tilemap(GLvoid* pointer) {
+    Tilemap* tilemap = pointer;
+    GLint    i       = 0;
+
+    flush_batch(&batch);
+
+    for (i = 0; i < tilemap->chunk_columns * tilemap->chunk_rows; i++) {
+        if (tilemap->chunks[i].VAO == 0u) continue;
+
+        if (render_state.VAO == tilemap->chunks[i].VAO) render_state.VAO = 0u;
+
+        glDeleteVertexArrays(1, &(tilemap->chunks[i].VAO));
+        glDeleteBuffers     (1, &(tilemap->chunks[i].VBO));
+    }
+
+    glDeleteBuffers(1, &(tilemap->EBO));
+    free           (tilemap->tiles);
+    free           (tilemap->chunks);
+    free           (tilemap->vertices);
+    free_resource  (&(resources[RESOURCE_TILEMAP]), tilemap);
+}
+
+GLvoid free_world(GLvoid* pointer) {
+    World* world = pointer;
+    GLint  i     = 0;
+
+    pthread_mutex_lock    (&(world->mutex));
+    world->running = false;
+    pthread_cond_broadcast(&(world->job_ready));
+    pthread_mutex_unlock  (&(world->mutex));
+
+    for (i = 0; i < world->worker_count; i++) pthread_join(world->workers[i], NULL);
+
+    for (i = 0; i < WORLD_BUCKETS; i++) {
+        while (world->buckets[i] != NULL) evict_world_chunk(world, world->buckets[i]);
+    }
+
+    glDeleteBuffers      (1, &(world->EBO));
+    pthread_mutex_destroy(&(world->mutex));
+    pthread_cond_destroy (&(world->job_ready));
+    free_resource        (&(resources[RESOURCE_WORLD]), world);
+}
+
+GLvoid free_font(GLvoid* pointer) {
+    Font* font = pointer;
+    GLint i    = 0;
+
+    for (i = 0; i < TEXT_CACHE_BUCKETS; i++) {
+        while (font->buckets[i] != NULL) delete_text_run(font, font->buckets[i]);
+    }
+
+    glDeleteBuffers(1, &(font->EBO));
+    free           (font->tiles);
+    free           (font->vertices);
+    free_resource  (&(resources[RESOURCE_FONT]), font);
+}
+
+GLvoid free_texture(GLvoid* pointer) {
+    release_texture(&texture_cache, pointer);
+}
+
+GLvoid set_window_icon(GLFWwindow* window, const char* icon_path) {
+    if (window != NULL) {
+        GLFWimage icon_image;
+
+        icon_image.pixels = stbi_load(icon_path, &icon_image.width, &icon_image.height, 0, 4);
+
+        if (icon_image.pixels != NULL) {
+            glfwSetWindowIcon(window, 1, &icon_image);
+            stbi_image_free  (icon_image.pixels);
+        } else {
+            printf("Error (%s): Failed to open icon file: %s.\n", __func__, icon_path);
+        }
+    }
+}
+
+char* read_file(const char* file_path) {
+    FILE* file      = fopen(file_path, "rb");
+    char* file_data = NULL;
+
+    if (file != NULL) {
+        fseek(file, 0L, SEEK_END);
+
+        const long file_size = ftell(file);
+
+        rewind(file);
+
+        file_data = malloc(file_size + 1);
+
+        if (file_data != NULL) {
+            file_data[fread(file_data, 1, file_size, file)] = '\0';
+        }
+
+        fclose(file);
+    } else {
+        printf("Error (%s): File not found: %s.\n", __func__, file_path);
+    }
+
+    return file_data;
+}
+
+const GLchar* shader_source(const GLchar* path, GLchar** file_data) {
+    const PackEntry* entry = find_pack_entry(&pack, path, PACK_SHADER);
+
+    *file_data = (entry == NULL) ? read_file(path) : NULL;
+
+    return (entry != NULL) ? (const GLchar*)&(pack.data[entry->offset]) : *file_data;
+}
+
+GLuint compile_shader(GLenum type, const GLchar* source, const GLchar* path) {
+    GLuint shader  = glCreateShader(type);
+    GLint  success = 0;
+
+    glShaderSource (shader, 1, &source, NULL);
+    glCompileShader(shader);
+    glGetShaderiv  (shader, GL_COMPILE_STATUS, &success);
+
+    if (success == 0) {
+        GLint   log_length = 0;
+        GLchar* info_log   = NULL;
+
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_length);
+
+        info_log = malloc((log_length > 0) ? log_length : 1);
+
+        if (info_log != NULL) {
+            info_log[0] = '\0';
+
+            glGetShaderInfoLog(shader, log_length, NULL, info_log);
+            printf            ("Error (%s): %s: %s\n", __func__, path, info_log);
+            free              (info_log);
+        }
+
+        glDeleteShader(shader);
+
+        return 0u;
+    }
+
+    return shader;
+}
+
+GLuint build_program(const GLchar* vertex_source, const GLchar* fragment_source, const GLchar* vertex_path, const GLchar* fragment_path) {
+    GLuint vertex   = compile_shader(GL_VERTEX_SHADER,   vertex_source,   vertex_path);
+    GLuint fragment = compile_shader(GL_FRAGMENT_SHADER, fragment_source, fragment_path);
+    GLuint program  = 0u;
+
+    if (vertex != 0u && fragment != 0u) {
+        program = glCreateProgram();
+
+        if (program_binaries()) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram (program);
+        glDetachShader(program, vertex);
+        glDetachShader(program, fragment);
+
+        if (!check_program(program)) {
+            glDeleteProgram(program);
+
+            program = 0u;
+        }
+    }
+
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    return program;
+}
+
+bool check_program(GLuint program) {
+    GLint success = 0;
+
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+    if (success == 0) {
+        GLint   log_length = 0;
+        GLchar* info_log   = NULL;
+
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
+
+        info_log = malloc((log_length > 0) ? log_length : 1);
+
+        if (info_log != NULL) {
+            info_log[0] = '\0';
+
+            glGetProgramInfoLog(program, log_length, NULL, info_log);
+            printf             ("Error (%s): %s\n", __func__, info_log);
+            free               (info_log);
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t hash_bytes(uint64_t hash, const GLvoid* bytes, size_t size) {
+    const GLubyte* data = bytes;
+    size_t         i    = 0;
+
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+uint64_t program_key(const GLchar* vertex_source, const GLchar* fragment_source) {
+    const GLchar* parts[5] = {
+        vertex_source,
+        fragment_source,
+        (const GLchar*)glGetString(GL_VENDOR),
+        (const GLchar*)glGetString(GL_RENDERER),
+        (const GLchar*)glGetString(GL_VERSION)
+    };
+    uint64_t hash = 0xCBF29CE484222325ull;
+    GLint    i    = 0;
+
+    for (i = 0; i < 5; i++) {
+        if (parts[i] != NULL) hash = hash_bytes(hash, parts[i], strlen(parts[i]) + 1);
+    }
+
+    return hash;
+}
+
+GLvoid program_cache_path(GLchar* path, size_t size, const GLchar* vertex_path, const GLchar* fragment_path) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    hash = hash_bytes(hash, vertex_path,   strlen(vertex_path)   + 1);
+    hash = hash_bytes(hash, fragment_path, strlen(fragment_path) + 1);
+
+    snprintf(path, size, "%s/program_%016llx.bin", PROGRAM_CACHE_DIRECTORY, (unsigned long long)hash);
+}
+
+bool program_binaries(GLvoid) {
+    GLint formats = 0;
+
+    if (!GLEW_ARB_get_program_binary) return false;
+
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    return formats > 0;
+}
+
+GLuint load_program_binary(const GLchar* cache_path, uint64_t key) {
+    if (!program_binaries()) return 0u;
+
+    FILE* file = fopen(cache_path, "rb");
+
+    if (file == NULL) return 0u;
+
+    ProgramCacheHeader header;
+    GLvoid*            binary  = NULL;
+    GLuint             program = 0u;
+
+    if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == PROGRAM_CACHE_MAGIC && header.key == key && header.length > 0u) {
+        binary = malloc(header.length);
+
+        if (binary != NULL && fread(binary, 1, header.length, file) == header.length) {
+            GLint success = 0;
+
+            program = glCreateProgram();
+
+            glProgramBinary(program, header.format, binary, header.length);
+            glGetProgramiv (program, GL_LINK_STATUS, &success);
+
+            if (success == 0) {
+                glDeleteProgram(program);
+
+                program = 0u;
+            }
+        }
+
+        free(binary);
+    }
+
+    fclose(file);
+
+    return program;
+}
+
+GLvoid save_program_binary(GLuint program, const GLchar* cache_path, uint64_t key) {
+    if (!program_binaries()) return;
+
+    GLint length = 0;
+
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0) return;
+
+    ProgramCacheHeader header = { .magic = PROGRAM_CACHE_MAGIC, .key = key };
+    GLvoid*            binary = malloc(length);
+    GLsizei            size   = 0;
+    GLenum             format = 0;
+
+    if (binary == NULL) return;
+
+    glGetProgramBinary(program, length, &size, &format, binary);
+
+    header.format = format;
+    header.length = size;
+
+#ifdef __linux__
+    mkdir(PROGRAM_CACHE_DIRECTORY, 0755);
+#elif _WIN32
+    CreateDirectoryA(PROGRAM_CACHE_DIRECTORY, NULL);
+#endif
+
+    FILE* file = (size > 0) ? fopen(cache_path, "wb") : NULL;
+
+    if (file != NULL) {
+        if (fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(binary, 1, size, file) != (size_t)size) {
+            printf("Error (%s): Failed to write program cache: %s.\n", __func__, cache_path);
+        }
+
+        fclose(file);
+    }
+
+    free(binary);
+}
+
+GLvoid setup_VBO(GLuint* VBO) {
+    static const GLfloat vertice[4 * 4] = {
+        -1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f
+    };
+
+    glBindBuffer             (GL_ARRAY_BUFFER, *VBO);
+    glBufferData             (GL_ARRAY_BUFFER, sizeof(vertice), vertice, GL_STATIC_DRAW);
+    glVertexAttribPointer    (0, 2, GL_FLOAT, false, 4 * sizeof(GLfloat), (void*)(0 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer    (1, 2, GL_FLOAT, false, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+}
+
+GLvoid setup_EBO(GLuint* EBO) {
+    static const GLuint indices[2 * 3] = {
+        0u, 1u, 3u,
+        1u, 2u, 3u
+    };
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+}
+
+GLuint alloc_mesh(MeshPool* pool) {
+    if (pool->free_count > 0u) {
+        const GLuint index = pool->free_list[--pool->free_count];
+
+        pool->used[index] = true;
+
+        return index;
+    }
+
+    if (pool->count == pool->capacity) {
+        const GLuint capacity = (pool->capacity > 0u) ? pool->capacity * 2u : MESH_POOL_CAPACITY;
+        bool         failed   = false;
+        size_t       i        = 0;
+
+        GLvoid** arrays[] = {
+            (GLvoid**)&(pool->position_x), (GLvoid**)&(pool->position_y), (GLvoid**)&(pool->position_z),
+            (GLvoid**)&(pool->scale_x),    (GLvoid**)&(pool->scale_y),    (GLvoid**)&(pool->cosine),
+            (GLvoid**)&(pool->sine),       (GLvoid**)&(pool->models),     (GLvoid**)&(pool->parents),
+            (GLvoid**)&(pool->versions),   (GLvoid**)&(pool->parent_versions), (GLvoid**)&(pool->resolved),
+            (GLvoid**)&(pool->dirty),      (GLvoid**)&(pool->used),       (GLvoid**)&(pool->free_list)
+        };
+
+        const size_t sizes[] = {
+            sizeof(GLfloat), sizeof(GLfloat), sizeof(GLfloat),
+            sizeof(GLfloat), sizeof(GLfloat), sizeof(GLfloat),
+            sizeof(GLfloat), sizeof(Mat4),    sizeof(GLuint),
+            sizeof(GLuint),  sizeof(GLuint),  sizeof(GLuint),
+            sizeof(GLubyte), sizeof(bool),    sizeof(GLuint)
+        };
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            GLvoid* array = realloc(*arrays[i], capacity * sizes[i]);
+
+            if (array != NULL) {
+                *arrays[i] = array;
+            } else {
+                failed = true;
+            }
+        }
+
+        if (failed) return pool->capacity;
+
+        memset(&(pool->dirty[pool->capacity]), 0, capacity - pool->capacity);
+
+        pool->capacity = capacity;
+    }
+
+    pool->used[pool->count] = true;
+
+    return pool->count++;
+}
+
+GLvoid free_mesh(MeshPool* pool, GLuint index) {
+    GLuint i = 0;
+
+    if (pool->child_count > 0u) {
+        if (pool->parents[index] != 0u) pool->child_count--;
+
+        for (i = 0; i < pool->count; i++) {
+            if (pool->used[i] && pool->parents[i] == index + 1u) {
+                pool->parents[i] = 0u;
+                pool->child_count--;
+
+                mark_mesh_dirty(pool, i);
+            }
+        }
+    }
+
+    if (pool->dirty[index]) pool->dirty_count--;
+
+    if (index < spatial.capacity && spatial.states[index] != COLLIDER_NONE) {
+        remove_collider(&spatial, index);
+
+        spatial.states[index] = COLLIDER_NONE;
+    }
+
+    pool->parents[index]                = 0u;
+    pool->dirty  [index]                = 0u;
+    pool->used   [index]                = false;
+    pool->free_list[pool->free_count++] = index;
+}
+
+GLuint get_mesh(MeshPool* pool, GLvoid* handle) {
+    const uintptr_t index = (uintptr_t)handle;
+
+    if (index == 0u || index > pool->count || !pool->used[index - 1u]) return pool->capacity;
+
+    return (GLuint)(index - 1u);
+}
+
+GLvoid delete_mesh_pool(MeshPool* pool) {
+    free(pool->position_x);
+    free(pool->position_y);
+    free(pool->position_z);
+    free(pool->scale_x);
+    free(pool->scale_y);
+    free(pool->cosine);
+    free(pool->sine);
+    free(pool->models);
+    free(pool->parents);
+    free(pool->versions);
+    free(pool->parent_versions);
+    free(pool->resolved);
+    free(pool->dirty);
+    free(pool->used);
+    free(pool->free_list);
+
+    memset(pool, 0, sizeof(MeshPool));
+}
+
+GLvoid mark_mesh_dirty(MeshPool* pool, GLuint index) {
+    if (!pool->dirty[index]) {
+        pool->dirty[index] = 1u;
+        pool->dirty_count++;
+    }
+
+    if (index < spatial.capacity && spatial.states[index] == COLLIDER_ACTIVE) {
+        spatial.states [index]                   = COLLIDER_PENDING;
+        spatial.pending[spatial.pending_count++] = index;
+    }
+}
+
+Mat4* mesh_model(MeshPool* pool, GLuint index) {
+    if (pool->dirty_count > 0u || pool->parents[index] != 0u) resolve_mesh(pool, index);
+
+    return &(pool->models[index]);
+}
+
+GLuint update_transforms(MeshPool* pool) {
+    const GLuint updated = pool->dirty_count;
+    GLuint       base    = 0;
+    GLuint       lane    = 0;
+
+    if (updated == 0u) return 0u;
+
+    for (base = 0; base < pool->count; base += 4u) {
+        const GLuint lanes = (pool->count - base < 4u) ? pool->count - base : 4u;
+        uint32_t     mask  = 0u;
+
+        if (lanes == 4u) memcpy(&mask, &(pool->dirty[base]), sizeof(mask));
+        else for (lane = 0; lane < lanes; lane++) mask |= pool->dirty[base + lane];
+
+        if (mask == 0u) continue;
+
+#if defined(__SSE__) || defined(_M_X64)
+        if (lanes == 4u) {
+            const __m128 cosine  = _mm_loadu_ps(&(pool->cosine [base]));
+            const __m128 sine    = _mm_loadu_ps(&(pool->sine   [base]));
+            const __m128 scale_x = _mm_loadu_ps(&(pool->scale_x[base]));
+            const __m128 scale_y = _mm_loadu_ps(&(pool->scale_y[base]));
+            const __m128 zero    = _mm_setzero_ps();
+            __m128       x_axis[4];
+            __m128       y_axis[4];
+            __m128       origin[4];
+
+            x_axis[0] = _mm_mul_ps(cosine, scale_x);
+            x_axis[1] = _mm_mul_ps(sine,   scale_x);
+            x_axis[2] = zero;
+            x_axis[3] = zero;
+            y_axis[0] = _mm_sub_ps(zero, _mm_mul_ps(sine, scale_y));
+            y_axis[1] = _mm_mul_ps(cosine, scale_y);
+            y_axis[2] = zero;
+            y_axis[3] = zero;
+            origin[0] = _mm_loadu_ps(&(pool->position_x[base]));
+            origin[1] = _mm_loadu_ps(&(pool->position_y[base]));
+            origin[2] = _mm_loadu_ps(&(pool->position_z[base]));
+            origin[3] = _mm_set1_ps(1.0f);
+
+            _MM_TRANSPOSE4_PS(x_axis[0], x_axis[1], x_axis[2], x_axis[3]);
+            _MM_TRANSPOSE4_PS(y_axis[0], y_axis[1], y_axis[2], y_axis[3]);
+            _MM_TRANSPOSE4_PS(origin[0], origin[1], origin[2], origin[3]);
+
+            for (lane = 0; lane < 4u; lane++) {
+                Mat4* model = &(pool->models[base + lane]);
+
+                if (!pool->dirty[base + lane]) continue;
+
+                _mm_storeu_ps(model->m[0], x_axis[lane]);
+                _mm_storeu_ps(model->m[1], y_axis[lane]);
+                _mm_storeu_ps(model->m[2], _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f));
+                _mm_storeu_ps(model->m[3], origin[lane]);
+
+                pool->versions[base + lane]++;
+            }
+
+            continue;
+        }
+#endif
+
+        for (lane = 0; lane < lanes; lane++) {
+            if (!pool->dirty[base + lane]) continue;
+
+            local_transform(pool, base + lane, &(pool->models[base + lane]));
+
+            pool->versions[base + lane]++;
+        }
+    }
+
+    if (pool->child_count > 0u) {
+        pool->pass++;
+
+        for (base = 0; base < pool->count; base++) {
+            if (pool->used[base] && pool->parents[base] != 0u) resolve_transform(pool, base);
+        }
+    }
+
+    memset(pool->dirty, 0, pool->count);
+
+    pool->dirty_count = 0u;
+
+    return updated;
+}
+
+GLvoid local_transform(MeshPool* pool, GLuint index, Mat4* model) {
+    const GLfloat cosine  = pool->cosine [index];
+    const GLfloat sine    = pool->sine   [index];
+    const GLfloat scale_x = pool->scale_x[index];
+    const GLfloat scale_y = pool->scale_y[index];
+
+    *model = (Mat4){ .m = {
+        {  cosine * scale_x, sine   * scale_x, 0.0f, 0.0f },
+        { -sine   * scale_y, cosine * scale_y, 0.0f, 0.0f },
+        {  0.0f,             0.0f,             1.0f, 0.0f },
+        {  pool->position_x[index], pool->position_y[index], pool->position_z[index], 1.0f }
+    } };
+}
+
+GLvoid resolve_transform(MeshPool* pool, GLuint index) {
+    if (pool->resolved[index] == pool->pass) return;
+
+    pool->resolved[index] = pool->pass;
+
+    if (pool->parents[index] == 0u) return;
+
+    const GLuint parent = pool->parents[index] - 1u;
+
+    resolve_transform(pool, parent);
+
+    if (pool->dirty[index] || pool->parent_versions[index] != pool->versions[parent]) compose_transform(pool, index, parent);
+}
+
+GLvoid compose_transform(MeshPool* pool, GLuint index, GLuint parent) {
+    const Mat4* world = &(pool->models[parent]);
+    Mat4        local;
+    GLint       column = 0;
+    GLint       row    = 0;
+
+    local_transform(pool, index, &local);
+
+    for (column = 0; column < 4; column++) {
+        for (row = 0; row < 4; row++) {
+            pool->models[index].m[column][row] = world->m[0][row] * local.m[column][0]
+                                               + world->m[1][row] * local.m[column][1]
+                                               + world->m[2][row] * local.m[column][2]
+                                               + world->m[3][row] * local.m[column][3];
+        }
+    }
+
+    pool->parent_versions[index] = pool->versions[parent];
+    pool->versions[index]++;
+}
+
+GLvoid resolve_mesh(MeshPool* pool, GLuint index) {
+    if (pool->parents[index] != 0u) {
+        const GLuint parent = pool->parents[index] - 1u;
+
+        resolve_mesh(pool, parent);
+
+        if (pool->dirty[index] || pool->parent_versions[index] != pool->versions[parent]) compose_transform(pool, index, parent);
+    } else if (pool->dirty[index]) {
+        local_transform(pool, index, &(pool->models[index]));
+
+        pool->versions[index]++;
+    }
+
+    if (pool->dirty[index]) {
+        pool->dirty[index] = 0u;
+        pool->dirty_count--;
+    }
+}
+
+GLvoid setup_batch(Batch* batch) {
+    batch->instances = malloc(MAX_BATCH_INSTANCES * sizeof(Instance));
+    batch->count     = 0;
+    batch->shader    = NULL;
+    batch->texture   = 0u;
+    batch->active    = false;
+
+    if (batch->instances != NULL) {
+        glGenVertexArrays(1, &(batch->VAO));
+        glGenBuffers     (1, &(batch->VBO));
+        glGenBuffers     (1, &(batch->EBO));
+        glGenBuffers     (1, &(batch->instance_VBO));
+        bind_vertex_array(batch->VAO);
+        setup_VBO        (&(batch->VBO));
+        setup_EBO        (&(batch->EBO));
+        glBindBuffer     (GL_ARRAY_BUFFER, batch->instance_VBO);
+        glBufferData     (GL_ARRAY_BUFFER, MAX_BATCH_INSTANCES * sizeof(Instance), NULL, GL_STREAM_DRAW);
+
+        GLuint column = 0u;
+
+        for (column = 0u; column < 4u; column++) {
+            glVertexAttribPointer    (2 + column, 4, GL_FLOAT, false, sizeof(Instance), (void*)(column * sizeof(Vec4)));
+            glEnableVertexAttribArray(2 + column);
+            glVertexAttribDivisor    (2 + column, 1);
+        }
+
+        glVertexAttribPointer    (6, 4, GL_FLOAT, false, sizeof(Instance), (void*)offsetof(Instance, TexCoords));
+        glEnableVertexAttribArray(6);
+        glVertexAttribDivisor    (6, 1);
+        bind_vertex_array        (0u);
+    } else {
+        printf("Error (%s): Failed to allocate instance buffer.\n", __func__);
+    }
+}
+
+GLvoid delete_batch(Batch* batch) {
+    if (batch->instances != NULL) {
+        if (render_state.VAO == batch->VAO) render_state.VAO = 0u;
+
+        glDeleteVertexArrays(1, &(batch->VAO));
+        glDeleteBuffers     (1, &(batch->VBO));
+        glDeleteBuffers     (1, &(batch->EBO));
+        glDeleteBuffers     (1, &(batch->instance_VBO));
+        free                (batch->instances);
+
+        batch->instances = NULL;
+        batch->count     = 0;
+    }
+}
+
+GLvoid flush_batch(Batch* batch) {
+    if (render_queue.count > 0) submit_queue(&render_queue, batch);
+
+    if (batch->count > 0 && batch->shader != NULL) {
+        if (recording != NULL) {
+            record_instances(recording, batch);
+        } else {
+            use_program      (batch->shader->program);
+            upload_projection(batch->shader, batch->aspect);
+            draw_instances   (batch, batch->texture, batch->instances, batch->count);
+
+            render_state.draws++;
+        }
+
+        batch->count = 0;
+        batch->draw_calls++;
+    }
+}
+
+Instance* push_instance(Batch* batch, Shader* shader, GLuint texture, GLfloat aspect) {
+    if (render_queue.mode != SORT_NONE && batch->active) {
+        Instance* instance = queue_instance(&render_queue, shader, texture, aspect);
+
+        if (instance != NULL) return instance;
+    }
+
+    return batch_instance(batch, shader, texture, aspect);
+}
+
+Instance* batch_instance(Batch* batch, Shader* shader, GLuint texture, GLfloat aspect) {
+    if (batch->count == MAX_BATCH_INSTANCES || batch->shader != shader || batch->texture != texture) {
+        flush_batch(batch);
+    }
+
+    batch->shader  = shader;
+    batch->texture = texture;
+    batch->aspect  = aspect;
+
+    return &(batch->instances[batch->count++]);
+}
+
+Instance* queue_instance(RenderQueue* queue, Shader* shader, GLuint texture, GLfloat aspect) {
+    if (queue->count == queue->capacity) {
+        const GLuint capacity = (queue->capacity > 0u) ? queue->capacity * 2u : MAX_BATCH_INSTANCES;
+        bool         failed   = false;
+        size_t       i        = 0;
+
+        GLvoid** arrays[] = {
+            (GLvoid**)&(queue->items), (GLvoid**)&(queue->keys),  (GLvoid**)&(queue->key_scratch),
+            (GLvoid**)&(queue->order), (GLvoid**)&(queue->order_scratch)
+        };
+
+        const size_t sizes[] = {
+            sizeof(QueuedDraw), sizeof(uint64_t), sizeof(uint64_t),
+            sizeof(uint32_t),   sizeof(uint32_t)
+        };
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            GLvoid* array = realloc(*arrays[i], capacity * sizes[i]);
+
+            if (array != NULL) {
+                *arrays[i] = array;
+            } else {
+                failed = true;
+            }
+        }
+
+        if (failed) return NULL;
+
+        queue->capacity = capacity;
+    }
+
+    QueuedDraw* item = &(queue->items[queue->count++]);
+
+    item->shader  = shader;
+    item->texture = texture;
+    item->aspect  = aspect;
+    item->layer   = queue->layer;
+
+    return &(item->instance);
+}
+
+uint32_t sortable_float(GLfloat value) {
+    uint32_t bits = 0u;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+uint64_t sort_key(const RenderQueue* queue, const QueuedDraw* item) {
+    const uint64_t layer   = (uint64_t)item->layer << 56;
+    const uint64_t shader  = (uint64_t)(item->shader->program & 0xFFu);
+    const uint64_t texture = (uint64_t)(item->texture & 0xFFFFu);
+
+    if (queue->mode == SORT_STATE) {
+        return layer | shader << 48 | texture << 32 | sortable_float(item->instance.Model.m[3][2]);
+    }
+
+    const GLfloat depth = (queue->mode == SORT_Y) ? -item->instance.Model.m[3][1] : item->instance.Model.m[3][2];
+
+    return layer | (uint64_t)sortable_float(depth) << 24 | shader << 16 | texture;
+}
+
+GLvoid radix_sort(RenderQueue* queue, GLuint count) {
+    GLuint shift = 0;
+
+    for (shift = 0; shift < 64; shift += 8) {
+        GLuint    counts[RADIX_BUCKETS] = { 0 };
+        GLuint    offset                = 0;
+        GLuint    i                     = 0;
+        uint64_t* keys                  = NULL;
+        uint32_t* order                 = NULL;
+
+        for (i = 0; i < count; i++) counts[(queue->keys[i] >> shift) & 0xFFu]++;
+
+        if (counts[(queue->keys[0] >> shift) & 0xFFu] == count) continue;
+
+        for (i = 0; i < RADIX_BUCKETS; i++) {
+            const GLuint bucket = counts[i];
+
+            counts[i]  = offset;
+            offset    += bucket;
+        }
+
+        for (i = 0; i < count; i++) {
+            const GLuint slot = counts[(queue->keys[i] >> shift) & 0xFFu]++;
+
+            queue->key_scratch  [slot] = queue->keys [i];
+            queue->order_scratch[slot] = queue->order[i];
+        }
+
+        keys  = queue->keys;
+        order = queue->order;
+
+        queue->keys          = queue->key_scratch;
+        queue->order         = queue->order_scratch;
+        queue->key_scratch   = keys;
+        queue->order_scratch = order;
+    }
+}
+
+GLuint count_state_changes(const RenderQueue* queue, const uint32_t* order, GLuint count) {
+    const QueuedDraw* previous = NULL;
+    GLuint            changes  = 0;
+    GLuint            i        = 0;
+
+    for (i = 0; i < count; i++) {
+        const QueuedDraw* item = &(queue->items[(order != NULL) ? order[i] : i]);
+
+        if (previous == NULL || item->shader != previous->shader || item->texture != previous->texture) changes++;
+
+        previous = item;
+    }
+
+    return changes;
+}
+
+GLvoid submit_queue(RenderQueue* queue, Batch* batch) {
+    const GLuint count = queue->count;
+    GLuint       i     = 0;
+
+    queue->count = 0;
+
+    for (i = 0; i < count; i++) {
+        queue->keys [i] = sort_key(queue, &(queue->items[i]));
+        queue->order[i] = i;
+    }
+
+    radix_sort(queue, count);
+
+    queue->submitted      = count;
+    queue->changes_before = count_state_changes(queue, NULL,         count);
+    queue->changes_after  = count_state_changes(queue, queue->order, count);
+
+    for (i = 0; i < count; i++) {
+        const QueuedDraw* item = &(queue->items[queue->order[i]]);
+
+        *batch_instance(batch, item->shader, item->texture, item->aspect) = item->instance;
+    }
+}
+
+GLvoid delete_render_queue(RenderQueue* queue) {
+    free(queue->items);
+    free(queue->keys);
+    free(queue->key_scratch);
+    free(queue->order);
+    free(queue->order_scratch);
+
+    queue->items         = NULL;
+    queue->keys          = NULL;
+    queue->key_scratch   = NULL;
+    queue->order         = NULL;
+    queue->order_scratch = NULL;
+    queue->count         = 0u;
+    queue->capacity      = 0u;
+}
+
+GLvoid draw_instances(Batch* batch, GLuint texture, const Instance* instances, GLsizei count) {
+    bind_texture           (texture);
+    bind_vertex_array      (batch->VAO);
+    glBindBuffer           (GL_ARRAY_BUFFER, batch->instance_VBO);
+    glBufferData           (GL_ARRAY_BUFFER, MAX_BATCH_INSTANCES * sizeof(Instance), NULL, GL_STREAM_DRAW);
+    glBufferSubData        (GL_ARRAY_BUFFER, 0, count * sizeof(Instance), instances);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (GLvoid*)0, count);
+}
+
+GLvoid set_projection(Shader* shader, const Mat4* projection) {
+    glUniformMatrix4fv(shader->Projection, 1, false, (const GLfloat*)projection);
+
+    shader->view = 0u;
+    render_state.issued++;
+}
+
+GLvoid clear_screen(GLclampf red, GLclampf green, GLclampf blue) {
+    glClear     (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClearColor(red, green, blue, 1.0f);
+}
+
+GLvoid bind_framebuffer(Framebuffer* framebuffer, const Vec4* color, GLint width, GLint height, bool timed) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->FBO);
+    glViewport       (0, 0, width, height);
+    glEnable         (GL_DEPTH_TEST);
+    glClearColor     (color->v[0], color->v[1], color->v[2], color->v[3]);
+    glClear          (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if (timed) {
+        if (framebuffer->queries[0][0] == 0u) glGenQueries(FRAMEBUFFER_QUERIES * 2, &(framebuffer->queries[0][0]));
+
+        glQueryCounter(framebuffer->queries[framebuffer->query_index][0], GL_TIMESTAMP);
+
+        framebuffer->timing = true;
+    }
+}
+
+GLvoid unbind_framebuffer(Framebuffer* framebuffer, GLclampf red, GLclampf green, GLclampf blue) {
+    if (framebuffer->timing) {
+        glQueryCounter(framebuffer->queries[framebuffer->query_index][1], GL_TIMESTAMP);
+
+        framebuffer->query_index = (framebuffer->query_index + 1) % FRAMEBUFFER_QUERIES;
+        framebuffer->timing      = false;
+
+        if (framebuffer->query_count < FRAMEBUFFER_QUERIES) framebuffer->query_count++;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0u);
+    glViewport       (0, 0, framebuffer->window_width, framebuffer->window_height);
+    glDisable        (GL_DEPTH_TEST);
+    glClearColor     (red, green, blue, 1.0f);
+    glClear          (GL_COLOR_BUFFER_BIT);
+}
+
+GLvoid present_framebuffer(Framebuffer* framebuffer, GLint source_width, GLint source_height, GLclampf red, GLclampf green, GLclampf blue) {
+    const GLint scale_x       = framebuffer->window_width  / framebuffer->texture.width;
+    const GLint scale_y       = framebuffer->window_height / framebuffer->texture.height;
+    const GLint scale         = (scale_x < scale_y) ? scale_x : scale_y;
+    const GLint target_width  = (scale > 0) ? framebuffer->texture.width  * scale : framebuffer->window_width;
+    const GLint target_height = (scale > 0) ? framebuffer->texture.height * scale : framebuffer->window_height;
+    const GLint x             = (framebuffer->window_width  - target_width)  / 2;
+    const GLint y             = (framebuffer->window_height - target_height) / 2;
+
+    unbind_framebuffer(framebuffer, red, green, blue);
+    glBindFramebuffer (GL_READ_FRAMEBUFFER, framebuffer->FBO);
+    glBlitFramebuffer (0, 0, source_width, source_height, x, y, x + target_width, y + target_height, GL_COLOR_BUFFER_BIT, framebuffer->filter);
+    glBindFramebuffer (GL_READ_FRAMEBUFFER, 0u);
+}
+
+GLvoid set_render_scale(Framebuffer* framebuffer, GLfloat scale) {
+    const GLint width  = (GLint)(framebuffer->texture.width  * scale + 0.5f);
+    const GLint height = (GLint)(framebuffer->texture.height * scale + 0.5f);
+
+    framebuffer->scale         = scale;
+    framebuffer->render_width  = (width  > 0) ? width  : 1;
+    framebuffer->render_height = (height > 0) ? height : 1;
+    framebuffer->texture.rect  = (Vec4){ .v = {
+        0.0f,
+        0.0f,
+        (GLfloat)framebuffer->render_width  / (GLfloat)framebuffer->texture.width,
+        (GLfloat)framebuffer->render_height / (GLfloat)framebuffer->texture.height
+    } };
+}
+
+GLvoid update_resolution(Framebuffer* framebuffer) {
+    const GLuint* queries   = framebuffer->queries[framebuffer->query_index];
+    GLint         available = 0;
+    GLuint64      start     = 0u;
+    GLuint64      end       = 0u;
+
+    if (framebuffer->query_count < FRAMEBUFFER_QUERIES) return;
+
+    glGetQueryObjectiv(queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (available == 0) return;
+
+    glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end);
+
+    const GLdouble time = (GLdouble)(end - start) / 1000000.0;
+
+    pthread_mutex_lock(&(renderer.mutex));
+
+    framebuffer->gpu_time = (framebuffer->gpu_time > 0.0) ? framebuffer->gpu_time * 0.9 + time * 0.1 : time;
+
+    if (framebuffer->budget > 0.0 && framebuffer->cooldown > 0) {
+        framebuffer->cooldown--;
+    } else if (framebuffer->budget > 0.0) {
+        GLfloat scale = framebuffer->target_scale;
+
+        if (framebuffer->gpu_time > framebuffer->budget) {
+            scale *= RESOLUTION_DOWN;
+        } else if (framebuffer->gpu_time < framebuffer->budget * RESOLUTION_HEADROOM) {
+            scale *= RESOLUTION_UP;
+        }
+
+        if (scale < framebuffer->min_scale) scale = framebuffer->min_scale;
+        if (scale > 1.0f)                   scale = 1.0f;
+
+        if (scale != framebuffer->target_scale) {
+            framebuffer->target_scale = scale;
+            framebuffer->gpu_time     = 0.0;
+            framebuffer->cooldown     = RESOLUTION_COOLDOWN;
+            framebuffer->query_count  = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&(renderer.mutex));
+}
+
+GLvoid apply_resolution(Framebuffer* framebuffer) {
+    pthread_mutex_lock(&(renderer.mutex));
+
+    const GLfloat scale = framebuffer->target_scale;
+
+    pthread_mutex_unlock(&(renderer.mutex));
+
+    if (scale != framebuffer->scale) set_render_scale(framebuffer, scale);
+}
+
+GLvoid use_program(GLuint program) {
+    if (render_state.program != program) {
+        glUseProgram(program);
+
+        render_state.program = program;
+        render_state.issued++;
+    } else {
+        render_state.skipped++;
+    }
+}
+
+GLvoid bind_texture(GLuint texture) {
+    if (render_state.texture != texture) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        render_state.texture = texture;
+        render_state.issued++;
+    } else {
+        render_state.skipped++;
+    }
+}
+
+GLvoid bind_vertex_array(GLuint VAO) {
+    if (render_state.VAO != VAO) {
+        glBindVertexArray(VAO);
+
+        render_state.VAO = VAO;
+        render_state.issued++;
+    } else {
+        render_state.skipped++;
+    }
+}
+
+GLvoid upload_projection(Shader* shader, GLfloat aspect) {
+    if (shader->aspect != aspect || shader->view != view.version) {
+        const Mat4 Projection = camera_projection(view.camera, aspect);
+
+        glUniformMatrix4fv(shader->Projection, 1, false, (const GLfloat*)&Projection);
+
+        shader->aspect = aspect;
+        shader->view   = view.version;
+        render_state.issued++;
+    } else {
+        render_state.skipped++;
+    }
+}
+
+GLint skyline_fit(AtlasPage* page, GLint index, GLint width, GLint height) {
+    GLint x          = page->skyline[index].x;
+    GLint y          = 0;
+    GLint width_left = width;
+
+    if (x + width > page->width) return -1;
+
+    while (width_left > 0) {
+        if (page->skyline[index].y > y) y = page->skyline[index].y;
+        if (y + height > page->height)  return -1;
+
+        width_left -= page->skyline[index].width;
+        index++;
+    }
+
+    return y;
+}
+
+bool skyline_insert(AtlasPage* page, GLint width, GLint height, GLint* x, GLint* y) {
+    GLint best_index  = -1;
+    GLint best_bottom = page->height + 1;
+    GLint best_width  = page->width  + 1;
+    GLint i           = 0;
+
+    if (page->pixels == NULL || page->skyline == NULL) return false;
+
+    for (i = 0; i < page->node_count; i++) {
+        const GLint fit_y = skyline_fit(page, i, width, height);
+
+        if (fit_y >= 0 && (fit_y + height < best_bottom || (fit_y + height == best_bottom && page->skyline[i].width < best_width))) {
+            best_index  = i;
+            best_bottom = fit_y + height;
+            best_width  = page->skyline[i].width;
+            *x          = page->skyline[i].x;
+            *y          = fit_y;
+        }
+    }
+
+    if (best_index < 0) return false;
+
+    memmove(&(page->skyline[best_index + 1]), &(page->skyline[best_index]), (page->node_count - best_index) * sizeof(SkylineNode));
+
+    page->skyline[best_index] = (SkylineNode){ *x, *y + height, width };
+    page->node_count++;
+
+    for (i = best_index + 1; i < page->node_count; i++) {
+        const GLint shrink = page->skyline[i - 1].x + page->skyline[i - 1].width - page->skyline[i].x;
+
+        if (shrink <= 0) break;
+
+        page->skyline[i].x     += shrink;
+        page->skyline[i].width -= shrink;
+
+        if (page->skyline[i].width > 0) break;
+
+        memmove(&(page->skyline[i]), &(page->skyline[i + 1]), (page->node_count - i - 1) * sizeof(SkylineNode));
+        page->node_count--;
+        i--;
+    }
+
+    for (i = 0; i < page->node_count - 1; i++) {
+        if (page->skyline[i].y == page->skyline[i + 1].y) {
+            page->skyline[i].width += page->skyline[i + 1].width;
+
+            memmove(&(page->skyline[i + 1]), &(page->skyline[i + 2]), (page->node_count - i - 2) * sizeof(SkylineNode));
+            page->node_count--;
+            i--;
+        }
+    }
+
+    return true;
+}
+
+GLvoid blit_padded(AtlasPage* page, AtlasImage* image, GLint padding) {
+    GLint row    = 0;
+    GLint column = 0;
+
+    for (row = -padding; row < image->height + padding; row++) {
+        const GLint source_row = (row < 0) ? 0 : (row >= image->height) ? image->height - 1 : row;
+        GLubyte*    target     = &(page->pixels[((image->y + padding + row) * page->width + image->x) * TEXTURE_CHANNELS]);
+
+        for (column = -padding; column < image->width + padding; column++) {
+            const GLint source_column = (column < 0) ? 0 : (column >= image->width) ? image->width - 1 : column;
+
+            memcpy(target, &(image->pixels[(source_row * image->width + source_column) * TEXTURE_CHANNELS]), TEXTURE_CHANNELS);
+
+            target += TEXTURE_CHANNELS;
+        }
+    }
+}
+
+int compare_heights(const void* a, const void* b) {
+    const AtlasImage* first  = a;
+    const AtlasImage* second = b;
+
+    if (first->height != second->height) return second->height - first->height;
+
+    return second->width - first->width;
+}
+
+GLuint hash_path(const GLchar* path) {
+    GLuint hash = 2166136261u;
+
+    while (*path != '\0') {
+        hash ^= (GLubyte)*path++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+Texture* acquire_texture(TextureCache* cache, const GLchar* path, bool async) {
+    const GLuint bucket  = hash_path(path) % TEXTURE_CACHE_BUCKETS;
+    Texture*     texture = cache->buckets[bucket];
+
+    while (texture != NULL && strcmp(texture->path, path) != 0) texture = texture->next;
+
+    if (texture != NULL) {
+        texture->references++;
+
+        return texture;
+    }
+
+    const size_t path_size = strlen(path) + 1;
+
+    texture = alloc_resource(&(resources[RESOURCE_TEXTURE]));
+
+    if (texture == NULL || (texture->path = malloc(path_size)) == NULL) {
+        printf       ("Error (%s): Failed to allocate texture: %s.\n", __func__, path);
+        free_resource(&(resources[RESOURCE_TEXTURE]), texture);
+
+        return NULL;
+    }
+
+    memcpy       (texture->path, path, path_size);
+    glGenTextures(1, &(texture->ID));
+
+    texture->rect       = (Vec4){ .v = { 0.0f, 0.0f, 1.0f, 1.0f } };
+    texture->references = 1;
+    texture->state      = TEXTURE_QUEUED;
+    texture->next       = cache->buckets[bucket];
+
+    cache->buckets[bucket] = texture;
+
+    const PackEntry* entry = find_pack_entry(&pack, path, PACK_TEXTURE);
+
+    if (entry != NULL && entry->channels == TEXTURE_CHANNELS) {
+        texture->pixels = (GLubyte*)&(pack.data[entry->offset]);
+        texture->mapped = true;
+        texture->width  = entry->width;
+        texture->height = entry->height;
+        texture->opaque = opaque_pixels(texture->pixels, (size_t)entry->width * entry->height);
+        texture->state  = TEXTURE_DECODED;
+
+        if (async) {
+            pthread_mutex_lock(&(cache->mutex));
+
+            if (cache->last_decoded != NULL) {
+                cache->last_decoded->next_job = texture;
+            } else {
+                cache->decoded = texture;
+            }
+
+            cache->last_decoded = texture;
+
+            pthread_mutex_unlock(&(cache->mutex));
+        }
+
+        return texture;
+    }
+
+    if (async) {
+        pthread_mutex_lock(&(cache->mutex));
+
+        if (!cache->running) {
+            GLint workers = processor_count() - 1;
+
+            if (workers < 1)                  workers = 1;
+            if (workers > MAX_LOADER_THREADS) workers = MAX_LOADER_THREADS;
+
+            cache->running      = true;
+            cache->worker_count = 0;
+
+            while (cache->worker_count < workers) {
+                if (pthread_create(&(cache->workers[cache->worker_count]), NULL, decode_textures, cache) != 0) break;
+
+                cache->worker_count++;
+            }
+
+            cache->running = cache->worker_count > 0;
+        }
+
+        if (!cache->running) {
+            pthread_mutex_unlock(&(cache->mutex));
+            printf              ("Error (%s): Failed to start texture loader, loading synchronously.\n", __func__);
+
+            async = false;
+        }
+    }
+
+    if (async) {
+        if (cache->last_job != NULL) {
+            cache->last_job->next_job = texture;
+        } else {
+            cache->jobs = texture;
+        }
+
+        cache->last_job = texture;
+
+        pthread_cond_signal (&(cache->job_ready));
+        pthread_mutex_unlock(&(cache->mutex));
+    } else {
+        stbi_set_flip_vertically_on_load(true);
+
+        texture->pixels = load_pixels(path, &(texture->width), &(texture->height), &(texture->opaque));
+        texture->state  = TEXTURE_DECODED;
+    }
+
+    return texture;
+}
+
+GLvoid release_texture(TextureCache* cache, Texture* texture) {
+    if (--texture->references > 0) return;
+
+    finish_texture(cache, texture);
+    flush_batch   (&batch);
+
+    Texture** link = &(cache->buckets[hash_path(texture->path) % TEXTURE_CACHE_BUCKETS]);
+
+    while (*link != NULL && *link != texture) link = &((*link)->next);
+
+    if (*link != NULL) *link = texture->next;
+
+    if (render_state.texture == texture->ID) render_state.texture = 0u;
+    if (batch.texture == texture->ID)        batch.texture        = 0u;
+
+    glDeleteTextures(1, &(texture->ID));
+    free            (texture->path);
+    free_resource   (&(resources[RESOURCE_TEXTURE]), texture);
+}
+
+GLvoid finish_texture(TextureCache* cache, Texture* texture) {
+    pthread_mutex_lock(&(cache->mutex));
+
+    while (texture->state == TEXTURE_QUEUED) pthread_cond_wait(&(cache->job_done), &(cache->mutex));
+
+    Texture* previous = NULL;
+    Texture* current  = cache->decoded;
+
+    while (current != NULL && current != texture) {
+        previous = current;
+        current  = current->next_job;
+    }
+
+    if (current != NULL) {
+        if (previous != NULL) {
+            previous->next_job = current->next_job;
+        } else {
+            cache->decoded = current->next_job;
+        }
+
+        if (cache->last_decoded == current) cache->last_decoded = previous;
+    }
+
+    pthread_mutex_unlock(&(cache->mutex));
+
+    if (texture->state == TEXTURE_DECODED) upload_texture_rows(cache, texture, texture->height);
+}
+
+GLvoid upload_texture_rows(TextureCache* cache, Texture* texture, GLint rows) {
+    if (texture->pixels == NULL) {
+        printf("Error (%s): Failed to load texture file: %s.\n", __func__, texture->path);
+
+        texture->state = TEXTURE_READY;
+
+        return;
+    }
+
+    if (texture->uploaded_rows == 0) {
+        bind_texture   (texture->ID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D   (GL_TEXTURE_2D, 0, GL_RGBA8, texture->width, texture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+        set_resource_bytes(&(resources[RESOURCE_TEXTURE]), texture, (uint64_t)texture->width * texture->height * TEXTURE_CHANNELS);
+    }
+
+    if (rows > texture->height - texture->uploaded_rows) rows = texture->height - texture->uploaded_rows;
+
+    const GLsizeiptr size   = (GLsizeiptr)rows * texture->width * TEXTURE_CHANNELS;
+    const GLubyte*   pixels = &(texture->pixels[(size_t)texture->uploaded_rows * texture->width * TEXTURE_CHANNELS]);
+
+    bind_texture (texture->ID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (texture->mapped) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, texture->uploaded_rows, texture->width, rows, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    } else {
+        if (cache->PBO == 0u) glGenBuffers(1, &(cache->PBO));
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, cache->PBO);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+
+        GLvoid* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+        if (mapped != NULL) {
+            memcpy         (mapped, pixels, size);
+            glUnmapBuffer  (GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, texture->uploaded_rows, texture->width, rows, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)0);
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0u);
+    }
+
+    texture->uploaded_rows += rows;
+    render_state.uploads++;
+
+    if (texture->uploaded_rows == texture->height) {
+        if (!texture->mapped) stbi_image_free(texture->pixels);
+
+        texture->pixels = NULL;
+        texture->state  = TEXTURE_READY;
+    }
+}
+
+GLvoid upload_textures(TextureCache* cache, GLdouble budget) {
+    const GLdouble deadline = monotonic_time() + budget;
+
+    while (monotonic_time() < deadline) {
+        pthread_mutex_lock(&(cache->mutex));
+
+        Texture* texture = cache->decoded;
+
+        pthread_mutex_unlock(&(cache->mutex));
+
+        if (texture == NULL) break;
+
+        upload_texture_rows(cache, texture, TEXTURE_UPLOAD_ROWS);
+
+        if (texture->state == TEXTURE_READY) {
+            pthread_mutex_lock(&(cache->mutex));
+
+            cache->decoded = texture->next_job;
+
+            if (cache->decoded == NULL) cache->last_decoded = NULL;
+
+            pthread_mutex_unlock(&(cache->mutex));
+        }
+    }
+}
+
+GLvoid* decode_textures(GLvoid* argument) {
+    TextureCache* cache = argument;
+
+    stbi_set_flip_vertically_on_load_thread(true);
+    pthread_mutex_lock                     (&(cache->mutex));
+
+    while (cache->running) {
+        Texture* texture = cache->jobs;
+
+        if (texture == NULL) {
+            pthread_cond_wait(&(cache->job_ready), &(cache->mutex));
+
+            continue;
+        }
+
+        cache->jobs = texture->next_job;
+
+        if (cache->jobs == NULL) cache->last_job = NULL;
+
+        pthread_mutex_unlock(&(cache->mutex));
+
+        GLint    width  = 0;
+        GLint    height = 0;
+        bool     opaque = false;
+        GLubyte* pixels = load_pixels(texture->path, &width, &height, &opaque);
+
+        pthread_mutex_lock(&(cache->mutex));
+
+        texture->pixels   = pixels;
+        texture->opaque   = opaque;
+        texture->width    = width;
+        texture->height   = height;
+        texture->state    = TEXTURE_DECODED;
+        texture->next_job = NULL;
+
+        if (cache->last_decoded != NULL) {
+            cache->last_decoded->next_job = texture;
+        } else {
+            cache->decoded = texture;
+        }
+
+        cache->last_decoded = texture;
+
+        pthread_cond_broadcast(&(cache->job_done));
+    }
+
+    pthread_mutex_unlock(&(cache->mutex));
+
+    return NULL;
+}
+
+GLubyte* load_pixels(const GLchar* path, GLint* width, GLint* height, bool* opaque) {
+    GLint    channels = 0;
+    GLubyte* pixels   = stbi_load(path, width, height, &channels, TEXTURE_CHANNELS);
+
+    if (pixels == NULL) return NULL;
+
+    if (channels != 2 && channels != 4) pack_color_key(pixels, (uint64_t)*width * *height);
+
+    *opaque = opaque_pixels(pixels, (size_t)*width * *height);
+
+    return pixels;
+}
+
+bool opaque_pixels(const GLubyte* pixels, size_t pixel_count) {
+    size_t i = 0;
+
+    for (i = 0; i < pixel_count; i++) {
+        if (pixels[i * TEXTURE_CHANNELS + 3] != 255u) return false;
+    }
+
+    return true;
+}
+
+GLvoid stop_texture_loader(TextureCache* cache) {
+    GLint i = 0;
+
+    pthread_mutex_lock(&(cache->mutex));
+
+    cache->running = false;
+
+    pthread_cond_broadcast(&(cache->job_ready));
+    pthread_mutex_unlock  (&(cache->mutex));
+
+    for (i = 0; i < cache->worker_count; i++) pthread_join(cache->workers[i], NULL);
+
+    while (cache->jobs != NULL) {
+        cache->jobs->state = TEXTURE_READY;
+        cache->jobs        = cache->jobs->next_job;
+    }
+
+    while (cache->decoded != NULL) {
+        if (!cache->decoded->mapped) stbi_image_free(cache->decoded->pixels);
+
+        cache->decoded->pixels = NULL;
+        cache->decoded->state  = TEXTURE_READY;
+        cache->decoded         = cache->decoded->next_job;
+    }
+
+    cache->last_job     = NULL;
+    cache->last_decoded = NULL;
+    cache->worker_count = 0;
+
+    if (cache->PBO != 0u) {
+        glDeleteBuffers(1, &(cache->PBO));
+
+        cache->PBO = 0u;
+    }
+}
+
+GLint processor_count(GLvoid) {
+#ifdef __linux__
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (GLint)count : 1;
+#elif _WIN32
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return (GLint)info.dwNumberOfProcessors;
+#endif
+}
+
+bool open_pack(Pack* pack, const GLchar* pack_path) {
+#ifdef __linux__
+    struct stat status;
+
+    pack->file = open(pack_path, O_RDONLY);
+
+    if (pack->file < 0) return false;
+
+    if (fstat(pack->file, &status) != 0 || status.st_size < (off_t)sizeof(PackHeader)) {
+        close(pack->file);
+
+        return false;
+    }
+
+    GLvoid* data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, pack->file, 0);
+
+    if (data == MAP_FAILED) {
+        close(pack->file);
+
+        return false;
+    }
+
+    pack->data = data;
+    pack->size = status.st_size;
+#elif _WIN32
+    LARGE_INTEGER size;
+
+    pack->file = CreateFileA(pack_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (pack->file == INVALID_HANDLE_VALUE) return false;
+
+    pack->mapping = CreateFileMappingA(pack->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (pack->mapping == NULL || !GetFileSizeEx(pack->file, &size) || size.QuadPart < (LONGLONG)sizeof(PackHeader)) {
+        if (pack->mapping != NULL) CloseHandle(pack->mapping);
+
+        CloseHandle(pack->file);
+
+        return false;
+    }
+
+    pack->data = MapViewOfFile(pack->mapping, FILE_MAP_READ, 0, 0, 0);
+    pack->size = (size_t)size.QuadPart;
+
+    if (pack->data == NULL) {
+        CloseHandle(pack->mapping);
+        CloseHandle(pack->file);
+
+        return false;
+    }
+#endif
+
+    const PackHeader* header = (const PackHeader*)pack->data;
+    GLuint            i      = 0u;
+
+    pack->entries     = (const PackEntry*)&(pack->data[sizeof(PackHeader)]);
+    pack->entry_count = header->entry_count;
+
+    if (header->magic != PACK_MAGIC || header->version != PACK_VERSION || sizeof(PackHeader) + (size_t)pack->entry_count * sizeof(PackEntry) > pack->size) {
+        printf    ("Error (%s): Invalid asset pack: %s.\n", __func__, pack_path);
+        close_pack(pack);
+
+        return false;
+    }
+
+    for (i = 0u; i < pack->entry_count; i++) {
+        const PackEntry* entry = &(pack->entries[i]);
+
+        if (memchr(entry->name, '\0', PACK_NAME_SIZE) == NULL) {
+            printf    ("Error (%s): Corrupt asset pack entry name: %s.\n", __func__, pack_path);
+            close_pack(pack);
+
+            return false;
+        }
+
+        bool corrupt = entry->offset > pack->size || entry->size > pack->size - entry->offset;
+
+        if (!corrupt && entry->type == PACK_TEXTURE) {
+            corrupt = entry->channels == 0u || (uint64_t)entry->width * entry->height > entry->size / entry->channels;
+        } else if (!corrupt && entry->type == PACK_SHADER) {
+            corrupt = memchr(&(pack->data[entry->offset]), '\0', entry->size) == NULL;
+        }
+
+        if (corrupt) {
+            printf    ("Error (%s): Corrupt asset pack entry: %s.\n", __func__, entry->name);
+            close_pack(pack);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+GLvoid close_pack(Pack* pack) {
+    if (pack->data != NULL) {
+#ifdef __linux__
+        munmap((GLvoid*)pack->data, pack->size);
+        close (pack->file);
+#elif _WIN32
+        UnmapViewOfFile(pack->data);
+        CloseHandle    (pack->mapping);
+        CloseHandle    (pack->file);
+#endif
+    }
+
+    pack->data        = NULL;
+    pack->size        = 0;
+    pack->entries     = NULL;
+    pack->entry_count = 0u;
+}
+
+const PackEntry* find_pack_entry(Pack* pack, const GLchar* name, PackType type) {
+    GLuint i = 0u;
+
+    for (i = 0u; i < pack->entry_count; i++) {
+        if (pack->entries[i].type == (uint32_t)type && strncmp(pack->entries[i].name, name, PACK_NAME_SIZE) == 0) return &(pack->entries[i]);
+    }
+
+    return NULL;
+}
+
+GLdouble monotonic_time(GLvoid) {
+#ifdef __linux__
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (GLdouble)now.tv_sec + (GLdouble)now.tv_nsec * 1.0e-9;
+#elif _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER        counter;
+
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+    QueryPerformanceCounter(&counter);
+
+    return (GLdouble)counter.QuadPart / (GLdouble)frequency.QuadPart;
+#endif
+}
+
+GLdouble process_time(GLvoid) {
+#ifdef __linux__
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+    return (GLdouble)now.tv_sec + (GLdouble)now.tv_nsec * 1.0e-9;
+#elif _WIN32
+    FILETIME creation;
+    FILETIME exited;
+    FILETIME kernel;
+    FILETIME user;
+
+    GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user);
+
+    const ULONGLONG total = ((ULONGLONG)kernel.dwHighDateTime << 32 | kernel.dwLowDateTime) + ((ULONGLONG)user.dwHighDateTime << 32 | user.dwLowDateTime);
+
+    return (GLdouble)total * 1.0e-7;
+#endif
+}
+
+GLvoid sleep_for(GLdouble seconds) {
+#ifdef __linux__
+    struct timespec duration;
+
+    duration.tv_sec  = (time_t)seconds;
+    duration.tv_nsec = (long)((seconds - (GLdouble)duration.tv_sec) * 1.0e9);
+
+    nanosleep(&duration, NULL);
+#elif _WIN32
+    Sleep((DWORD)(seconds * 1000.0));
+#endif
+}
+
+GLvoid wait_until(GLdouble target_time) {
+    GLdouble remaining = target_time - monotonic_time();
+
+    while (remaining > delay_tolerance) {
+        sleep_for(remaining - delay_tolerance);
+
+        remaining = target_time - monotonic_time();
+    }
+
+    while (monotonic_time() < target_time) {}
+}
+
+GLvoid build_tilemap_chunks(Tilemap* tilemap, const GLint* range) {
+    GLint x = 0;
+    GLint y = 0;
+
+    for (y = range[1]; y <= range[3]; y++) {
+        for (x = range[0]; x <= range[2]; x++) {
+            const TilemapChunk* chunk = &(tilemap->chunks[y * tilemap->chunk_columns + x]);
+
+            if (chunk->VAO == 0u || chunk->dirty) build_chunk(tilemap, x, y);
+        }
+    }
+}
+
+GLint draw_tilemap_chunks(Tilemap* tilemap, const GLint* range) {
+    GLint draw_calls = 0;
+    GLint x          = 0;
+    GLint y          = 0;
+
+    for (y = range[1]; y <= range[3]; y++) {
+        for (x = range[0]; x <= range[2]; x++) {
+            TilemapChunk* chunk = &(tilemap->chunks[y * tilemap->chunk_columns + x]);
+
+            if (chunk->quad_count > 0) {
+                bind_vertex_array(chunk->VAO);
+                glDrawElements   (GL_TRIANGLES, chunk->quad_count * 6, GL_UNSIGNED_SHORT, (GLvoid*)0);
+
+                draw_calls++;
+            }
+        }
+    }
+
+    return draw_calls;
+}
+
+GLvoid build_chunk(Tilemap* tilemap, GLint chunk_x, GLint chunk_y) {
+    TilemapChunk* chunk = &(tilemap->chunks[chunk_y * tilemap->chunk_columns + chunk_x]);
+    const GLsizei quads = fill_chunk(tilemap, chunk_x, chunk_y, tilemap->vertices);
+
+    upload_tile_quads(chunk, tilemap->EBO, tilemap->vertices, quads);
+}
+
+GLsizei fill_chunk(Tilemap* tilemap, GLint chunk_x, GLint chunk_y, GLfloat* vertices) {
+    TilemapChunk* chunk   = &(tilemap->chunks[chunk_y * tilemap->chunk_columns + chunk_x]);
+    const GLint   first_x = chunk_x * TILEMAP_CHUNK_SIZE;
+    const GLint   first_y = chunk_y * TILEMAP_CHUNK_SIZE;
+    const GLint   width   = (tilemap->width  - first_x < TILEMAP_CHUNK_SIZE) ? tilemap->width  - first_x : TILEMAP_CHUNK_SIZE;
+    const GLint   height  = (tilemap->height - first_y < TILEMAP_CHUNK_SIZE) ? tilemap->height - first_y : TILEMAP_CHUNK_SIZE;
+
+    chunk->dirty = false;
+
+    return fill_tile_quads(&(tilemap->sheet), &(tilemap->tiles[(size_t)first_y * tilemap->width + first_x]), tilemap->width, first_x, first_y, width, height, vertices);
+}
+
+GLsizei fill_tile_quads(const TileSheet* sheet, const uint16_t* tiles, GLint stride, GLint origin_x, GLint origin_y, GLint width, GLint height, GLfloat* vertices) {
+    const Vec4*   rect   = &(sheet->rect);
+    const GLfloat du     = rect->v[2] / (GLfloat)sheet->columns;
+    const GLfloat dv     = rect->v[3] / (GLfloat)sheet->rows;
+    const GLfloat size   = sheet->tile_size;
+    GLsizei       quads  = 0;
+    GLint         x      = 0;
+    GLint         y      = 0;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+            const GLint tile = tiles[(size_t)y * stride + x];
+
+            if (tile == 0) continue;
+
+            const GLfloat left   = (origin_x + x) * size;
+            const GLfloat bottom = (origin_y + y) * size;
+            const GLfloat u      = rect->v[0] + ((tile - 1) % sheet->columns) * du;
+            const GLfloat v      = rect->v[1] + ((tile - 1) / sheet->columns % sheet->rows) * dv;
+
+            const GLfloat quad[4 * 4] = {
+                left,        bottom + size, u,      v + dv,
+                left,        bottom,        u,      v,
+                left + size, bottom,        u + du, v,
+                left + size, bottom + size, u + du, v + dv
+            };
+
+            memcpy(&(vertices[quads * 16]), quad, sizeof(quad));
+
+            quads++;
+        }
+    }
+
+    return quads;
+}
+
+GLvoid upload_tile_quads(TilemapChunk* chunk, GLuint EBO, const GLfloat* vertices, GLsizei quads) {
+    if (chunk->VAO == 0u) {
+        glGenVertexArrays        (1, &(chunk->VAO));
+        glGenBuffers             (1, &(chunk->VBO));
+        bind_vertex_array        (chunk->VAO);
+        glBindBuffer             (GL_ARRAY_BUFFER, chunk->VBO);
+        glBindBuffer             (GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glVertexAttribPointer    (0, 2, GL_FLOAT, false, 4 * sizeof(GLfloat), (void*)(0 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer    (1, 2, GL_FLOAT, false, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(1);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, chunk->VBO);
+    glBufferData(GL_ARRAY_BUFFER, quads * 16 * sizeof(GLfloat), vertices, GL_STATIC_DRAW);
+
+    chunk->quad_count = quads;
+}
+
+GLuint create_tile_indices(GLvoid) {
+    uint16_t* indices = malloc(TILEMAP_CHUNK_TILES * 6 * sizeof(uint16_t));
+    GLuint    EBO     = 0u;
+    GLint     i       = 0;
+
+    if (indices != NULL) {
+        for (i = 0; i < TILEMAP_CHUNK_TILES; i++) {
+            indices[i * 6 + 0] = (uint16_t)(i * 4 + 0);
+            indices[i * 6 + 1] = (uint16_t)(i * 4 + 1);
+            indices[i * 6 + 2] = (uint16_t)(i * 4 + 3);
+            indices[i * 6 + 3] = (uint16_t)(i * 4 + 1);
+            indices[i * 6 + 4] = (uint16_t)(i * 4 + 2);
+            indices[i * 6 + 5] = (uint16_t)(i * 4 + 3);
+        }
+
+        bind_vertex_array(0u);
+        glGenBuffers     (1, &EBO);
+        glBindBuffer     (GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData     (GL_ELEMENT_ARRAY_BUFFER, TILEMAP_CHUNK_TILES * 6 * sizeof(uint16_t), indices, GL_STATIC_DRAW);
+        free             (indices);
+    } else {
+        printf("Error (%s): Failed to allocate tile indices.\n", __func__);
+    }
+
+    return EBO;
+}
+
+GLvoid begin_tile_draw(Shader* shader, GLfloat aspect, Texture* texture, const Vec3* position, GLfloat size) {
+    flush_batch      (&batch);
+    use_program      (shader->program);
+    upload_projection(shader, aspect);
+    setup_tile_draw  (texture->ID, position, size);
+}
+
+GLvoid setup_tile_draw(GLuint texture, const Vec3* position, GLfloat size) {
+    bind_texture     (texture);
+    glVertexAttrib4f (2, size, 0.0f, 0.0f, 0.0f);
+    glVertexAttrib4f (3, 0.0f, size, 0.0f, 0.0f);
+    glVertexAttrib4f (4, 0.0f, 0.0f, 1.0f, 0.0f);
+    glVertexAttrib4f (5, position->v[0], position->v[1], position->v[2], 1.0f);
+    glVertexAttrib4f (6, 0.0f, 0.0f, 1.0f, 1.0f);
+}
+
+GLfloat sample_noise(Noise* noise, GLfloat x, GLfloat y) {
+    if (noise->warp) fnlDomainWarp2D(&(noise->state), &x, &y);
+
+    return fnlGetNoise2D(&(noise->state), x, y);
+}
+
+GLvoid* fill_noise_rows(GLvoid* argument) {
+    NoiseJob* job    = argument;
+    GLfloat*  out    = &(job->out[(size_t)job->first_row * job->width]);
+    GLint     row    = 0;
+    GLint     column = 0;
+
+    for (row = job->first_row; row < job->last_row; row++) {
+        const GLfloat y = job->y + row * job->step;
+
+        for (column = 0; column < job->width; column++) *out++ = sample_noise(job->noise, job->x + column * job->step, y);
+    }
+
+    return NULL;
+}
+
+GLvoid generate_noise(Noise* noise, GLfloat x, GLfloat y, GLfloat step, GLint width, GLint height, GLfloat* out) {
+    pthread_t threads[MAX_NOISE_THREADS];
+    NoiseJob  jobs   [MAX_NOISE_THREADS];
+    GLint     count   = processor_count();
+    GLint     started = 0;
+    GLint     i       = 0;
+
+    if (count > MAX_NOISE_THREADS)                              count = MAX_NOISE_THREADS;
+    if (count > height)                                         count = height;
+    if ((size_t)width * height < NOISE_THREAD_SAMPLES || count < 1) count = 1;
+
+    for (i = 0; i < count; i++) {
+        jobs[i] = (NoiseJob){ noise, x, y, step, width, height * i / count, height * (i + 1) / count, out };
+    }
+
+    for (i = 1; i < count; i++) {
+        if (pthread_create(&(threads[i]), NULL, fill_noise_rows, &(jobs[i])) != 0) break;
+
+        started = i;
+    }
+
+    fill_noise_rows(&(jobs[0]));
+
+    for (i = started + 1; i < count; i++) fill_noise_rows(&(jobs[i]));
+    for (i = 1; i <= started; i++)        pthread_join(threads[i], NULL);
+}
+
+GLint read_noise_levels(lua_State* L, int index, NoiseLevels* levels) {
+    GLint i = 0;
+
+    luaL_checktype(L, index, LUA_TTABLE);
+
+    levels->count = (GLint)luaL_len(L, index);
+
+    luaL_argcheck(L, levels->count <= MAX_NOISE_LEVELS, index, "too many levels");
+
+    for (i = 0; i < levels->count; i++) {
+        lua_geti(L, index, i + 1);
+        luaL_checktype(L, -1, LUA_TTABLE);
+        lua_geti(L, -1, 1);
+        lua_geti(L, -2, 2);
+
+        levels->values[i] = (GLfloat)luaL_checknumber(L, -2);
+        levels->tiles [i] = (uint16_t)luaL_checkinteger(L, -1);
+
+        lua_pop(L, 3);
+    }
+
+    return levels->count;
+}
+
+uint16_t classify_noise(const NoiseLevels* levels, GLfloat value) {
+    uint16_t tile = 0;
+    GLint    i    = 0;
+
+    for (i = 0; i < levels->count && value >= levels->values[i]; i++) tile = levels->tiles[i];
+
+    return tile;
+}
+
+GLuint hash_chunk(GLint x, GLint y) {
+    return ((GLuint)x * 73856093u ^ (GLuint)y * 19349663u) % WORLD_BUCKETS;
+}
+
+WorldChunk* find_world_chunk(World* world, GLint x, GLint y) {
+    WorldChunk* chunk = world->buckets[hash_chunk(x, y)];
+
+    while (chunk != NULL && (chunk->x != x || chunk->y != y)) chunk = chunk->next;
+
+    return chunk;
+}
+
+WorldChunk* take_world_job(World* world) {
+    WorldChunk* best          = NULL;
+    GLint       best_distance = 0;
+    WorldChunk* chunk         = NULL;
+
+    for (chunk = world->jobs; chunk != NULL; chunk = chunk->next_job) {
+        const GLint dx       = abs(chunk->x - world->focus_x);
+        const GLint dy       = abs(chunk->y - world->focus_y);
+        const GLint distance = (dx > dy) ? dx : dy;
+
+        if (best == NULL || distance < best_distance) {
+            best          = chunk;
+            best_distance = distance;
+        }
+    }
+
+    if (best != NULL) {
+        unlink_world_job(world, best);
+
+        best->state = CHUNK_WORKING;
+    }
+
+    return best;
+}
+
+GLvoid unlink_world_job(World* world, WorldChunk* chunk) {
+    WorldChunk** link = &(world->jobs);
+
+    while (*link != NULL && *link != chunk) link = &((*link)->next_job);
+
+    if (*link != NULL) *link = chunk->next_job;
+
+    chunk->next_job = NULL;
+}
+
+GLvoid generate_world_chunk(World* world, WorldChunk* chunk) {
+    const GLfloat origin_x = (GLfloat)(chunk->x * TILEMAP_CHUNK_SIZE);
+    const GLfloat origin_y = (GLfloat)(chunk->y * TILEMAP_CHUNK_SIZE);
+    GLint         x        = 0;
+    GLint         y        = 0;
+
+    for (y = 0; y < TILEMAP_CHUNK_SIZE; y++) {
+        for (x = 0; x < TILEMAP_CHUNK_SIZE; x++) {
+            chunk->tiles[y * TILEMAP_CHUNK_SIZE + x] = classify_noise(&(world->levels), sample_noise(&(world->noise), origin_x + x, origin_y + y));
+        }
+    }
+
+    chunk->vertices = malloc(TILEMAP_CHUNK_TILES * 4 * 4 * sizeof(GLfloat));
+
+    if (chunk->vertices != NULL) {
+        chunk->quad_count = fill_tile_quads(&(world->sheet), chunk->tiles, TILEMAP_CHUNK_SIZE, chunk->x * TILEMAP_CHUNK_SIZE, chunk->y * TILEMAP_CHUNK_SIZE, TILEMAP_CHUNK_SIZE, TILEMAP_CHUNK_SIZE, chunk->vertices);
+    } else {
+        chunk->quad_count = 0;
+    }
+}
+
+GLvoid* stream_world_chunks(GLvoid* argument) {
+    World* world = argument;
+
+    pthread_mutex_lock(&(world->mutex));
+
+    while (world->running) {
+        WorldChunk* chunk = take_world_job(world);
+
+        if (chunk == NULL) {
+            pthread_cond_wait(&(world->job_ready), &(world->mutex));
+
+            continue;
+        }
+
+        pthread_mutex_unlock(&(world->mutex));
+
+        generate_world_chunk(world, chunk);
+
+        pthread_mutex_lock(&(world->mutex));
+
+        chunk->state    = CHUNK_GENERATED;
+        chunk->next_job = world->done;
+        world->done     = chunk;
+    }
+
+    pthread_mutex_unlock(&(world->mutex));
+
+    return NULL;
+}
+
+GLvoid evict_world_chunk(World* world, WorldChunk* chunk) {
+    WorldChunk** link = &(world->buckets[hash_chunk(chunk->x, chunk->y)]);
+
+    while (*link != NULL && *link != chunk) link = &((*link)->next);
+
+    if (*link != NULL) *link = chunk->next;
+
+    if (chunk->state == CHUNK_READY) {
+        world->memory -= (size_t)chunk->quad_count * 16 * sizeof(GLfloat);
+        world->cached--;
+    }
+
+    if (chunk->mesh.VAO != 0u) {
+        if (render_state.VAO == chunk->mesh.VAO) render_state.VAO = 0u;
+
+        glDeleteVertexArrays(1, &(chunk->mesh.VAO));
+        glDeleteBuffers     (1, &(chunk->mesh.VBO));
+    }
+
+    world->memory -= sizeof(WorldChunk);
+
+    free(chunk->vertices);
+    free(chunk);
+}
+
+int compare_last_used(const void* a, const void* b) {
+    const WorldChunk* first  = *(WorldChunk* const*)a;
+    const WorldChunk* second = *(WorldChunk* const*)b;
+
+    if (first->last_used < second->last_used) return -1;
+
+    return (first->last_used > second->last_used) ? 1 : 0;
+}
+
+TextRun* find_text_run(Font* font, const GLchar* text) {
+    const GLuint hash = hash_path(text);
+    TextRun*     run  = font->buckets[hash % TEXT_CACHE_BUCKETS];
+
+    while (run != NULL && (run->hash != hash || strcmp(run->text, text) != 0)) run = run->next;
+
+    if (run == NULL) run = build_text_run(font, text, hash);
+
+    if (run != NULL) run->last_used = ++font->clock;
+
+    return run;
+}
+
+bool measure_text(const GLchar* text, GLint* width, GLint* height) {
+    GLint         columns = 0;
+    GLint         rows    = 1;
+    GLint         column  = 0;
+    const GLchar* c       = NULL;
+
+    for (c = text; *c != '\0'; c++) {
+        if (*c == '\n') {
+            column = 0;
+            rows++;
+        } else if (++column > columns) {
+            columns = column;
+        }
+    }
+
+    if (width  != NULL) *width  = columns;
+    if (height != NULL) *height = rows;
+
+    return (size_t)columns * rows <= TILEMAP_CHUNK_TILES;
+}
+
+GLvoid draw_text_run(TextRun* run) {
+    bind_vertex_array(run->mesh.VAO);
+    glDrawElements   (GL_TRIANGLES, run->mesh.quad_count * 6, GL_UNSIGNED_SHORT, (GLvoid*)0);
+}
+
+TextRun* build_text_run(Font* font, const GLchar* text, GLuint hash) {
+    GLint         width  = 0;
+    GLint         height = 0;
+    GLint         column = 0;
+    GLint         row    = 0;
+    const GLchar* c      = NULL;
+
+    if (!measure_text(text, &width, &height)) return NULL;
+
+    if (font->run_count >= TEXT_CACHE_CAPACITY) {
+        TextRun* oldest = NULL;
+        GLint    i      = 0;
+
+        for (i = 0; i < TEXT_CACHE_BUCKETS; i++) {
+            TextRun* run = NULL;
+
+            for (run = font->buckets[i]; run != NULL; run = run->next) {
+                if (oldest == NULL || run->last_used < oldest->last_used) oldest = run;
+            }
+        }
+
+        delete_text_run(font, oldest);
+    }
+
+    TextRun* run = calloc(1, sizeof(TextRun));
+
+    if (run == NULL || (run->text = strdup(text)) == NULL) {
+        printf("Error (%s): Failed to cache text.\n", __func__);
+        free  (run);
+
+        return NULL;
+    }
+
+    memset(font->tiles, 0, (size_t)width * height * sizeof(uint16_t));
+
+    for (c = text, column = 0, row = height - 1; *c != '\0'; c++) {
+        if (*c == '\n') {
+            column = 0;
+            row--;
+        } else {
+            const GLubyte glyph = (GLubyte)*c;
+
+            font->tiles[row * width + column++] = (glyph < FONT_GLYPHS) ? font->glyphs[glyph] : 0;
+        }
+    }
+
+    const GLsizei quads = fill_tile_quads(&(font->sheet), font->tiles, width, 0, 0, width, height, font->vertices);
+
+    if (quads > 0) upload_tile_quads(&(run->mesh), font->EBO, font->vertices, quads);
+
+    run->hash = hash;
+    run->next = font->buckets[hash % TEXT_CACHE_BUCKETS];
+
+    font->buckets[hash % TEXT_CACHE_BUCKETS] = run;
+    font->run_count++;
+
+    return run;
+}
+
+GLvoid delete_text_run(Font* font, TextRun* run) {
+    TextRun** link = &(font->buckets[run->hash % TEXT_CACHE_BUCKETS]);
+
+    while (*link != NULL && *link != run) link = &((*link)->next);
+
+    if (*link != NULL) *link = run->next;
+
+    if (run->mesh.VAO != 0u) {
+        if (render_state.VAO == run->mesh.VAO) render_state.VAO = 0u;
+
+        glDeleteVertexArrays(1, &(run->mesh.VAO));
+        glDeleteBuffers     (1, &(run->mesh.VBO));
+    }
+
+    font->run_count--;
+
+    free(run->text);
+    free(run);
+}
+
+bool reserve_colliders(SpatialHash* spatial, GLuint capacity) {
+    if (spatial->buckets == NULL) {
+        spatial->buckets = calloc(SPATIAL_BUCKETS, sizeof(SpatialBucket));
+
+        if (spatial->buckets == NULL) return false;
+    }
+
+    if (capacity > spatial->capacity) {
+        bool   failed = false;
+        size_t i      = 0;
+
+        GLvoid** arrays[] = {
+            (GLvoid**)&(spatial->bounds), (GLvoid**)&(spatial->ranges),  (GLvoid**)&(spatial->stamps),
+            (GLvoid**)&(spatial->states), (GLvoid**)&(spatial->pending), (GLvoid**)&(spatial->results)
+        };
+
+        const size_t sizes[] = {
+            sizeof(Vec4),    4 * sizeof(GLint), sizeof(GLuint),
+            sizeof(GLubyte), sizeof(GLuint),    sizeof(GLuint)
+        };
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            GLvoid* array = realloc(*arrays[i], capacity * sizes[i]);
+
+            if (array != NULL) {
+                *arrays[i] = array;
+            } else {
+                failed = true;
+            }
+        }
+
+        if (failed) return false;
+
+        memset(&(spatial->states[spatial->capacity]), COLLIDER_NONE, capacity - spatial->capacity);
+        memset(&(spatial->stamps[spatial->capacity]), 0, (capacity - spatial->capacity) * sizeof(GLuint));
+
+        spatial->capacity = capacity;
+    }
+
+    return true;
+}
+
+GLuint hash_cell(GLint x, GLint y) {
+    return ((GLuint)x * 73856093u ^ (GLuint)y * 19349663u) & (SPATIAL_BUCKETS - 1u);
+}
+
+GLvoid collider_bounds(SpatialHash* spatial, MeshPool* pool, GLuint index) {
+    const Mat4*   model       = &(pool->models[index]);
+    const GLfloat half_width  = fabsf(model->m[0][0]) + fabsf(model->m[1][0]);
+    const GLfloat half_height = fabsf(model->m[0][1]) + fabsf(model->m[1][1]);
+
+    spatial->bounds[index] = (Vec4){ .v = {
+        model->m[3][0] - half_width, model->m[3][1] - half_height,
+        model->m[3][0] + half_width, model->m[3][1] + half_height
+    } };
+}
+
+GLvoid insert_collider(SpatialHash* spatial, GLuint index) {
+    const GLint* range = &(spatial->ranges[index * 4]);
+    GLint        x     = 0;
+    GLint        y     = 0;
+
+    for (y = range[1]; y <= range[3]; y++) {
+        for (x = range[0]; x <= range[2]; x++) {
+            SpatialBucket* bucket = &(spatial->buckets[hash_cell(x, y)]);
+
+            if (bucket->count == bucket->capacity) {
+                const GLuint capacity = (bucket->capacity > 0u) ? bucket->capacity * 2u : 4u;
+                GLuint*      items    = realloc(bucket->items, capacity * sizeof(GLuint));
+
+                if (items == NULL) continue;
+
+                bucket->items    = items;
+                bucket->capacity = capacity;
+            }
+
+            bucket->items[bucket->count++] = index;
+        }
+    }
+}
+
+GLvoid remove_collider(SpatialHash* spatial, GLuint index) {
+    const GLint* range = &(spatial->ranges[index * 4]);
+    GLint        x     = 0;
+    GLint        y     = 0;
+    GLuint       i     = 0;
+
+    for (y = range[1]; y <= range[3]; y++) {
+        for (x = range[0]; x <= range[2]; x++) {
+            SpatialBucket* bucket = &(spatial->buckets[hash_cell(x, y)]);
+
+            for (i = 0; i < bucket->count; i++) {
+                if (bucket->items[i] != index) continue;
+
+                bucket->items[i] = bucket->items[--bucket->count];
+
+                break;
+            }
+        }
+    }
+}
+
+GLvoid update_colliders(SpatialHash* spatial, MeshPool* pool) {
+    GLuint i = 0;
+
+    if (spatial->capacity == 0u) return;
+
+    if (pool->dirty_count > 0u) update_transforms(pool);
+
+    if (pool->child_count > 0u) {
+        for (i = 0; i < pool->count && i < spatial->capacity; i++) {
+            if (spatial->states[i] == COLLIDER_ACTIVE && pool->parents[i] != 0u) {
+                spatial->states [i]                        = COLLIDER_PENDING;
+                spatial->pending[spatial->pending_count++] = i;
+            }
+        }
+    }
+
+    for (i = 0; i < spatial->pending_count; i++) {
+        const GLuint index = spatial->pending[i];
+        GLint*       range = &(spatial->ranges[index * 4]);
+
+        if (spatial->states[index] != COLLIDER_PENDING) continue;
+
+        collider_bounds(spatial, pool, index);
+
+        const Vec4* bounds = &(spatial->bounds[index]);
+        const GLint cells[4] = {
+            (GLint)floorf(bounds->v[0] / spatial->cell_size), (GLint)floorf(bounds->v[1] / spatial->cell_size),
+            (GLint)floorf(bounds->v[2] / spatial->cell_size), (GLint)floorf(bounds->v[3] / spatial->cell_size)
+        };
+
+        if (memcmp(range, cells, sizeof(cells)) != 0) {
+            remove_collider(spatial, index);
+            memcpy         (range, cells, sizeof(cells));
+            insert_collider(spatial, index);
+        }
+
+        spatial->states[index] = COLLIDER_ACTIVE;
+    }
+
+    spatial->pending_count = 0u;
+}
+
+GLuint query_colliders(SpatialHash* spatial, const Vec4* area, GLuint exclude) {
+    const GLfloat first_x = floorf(area->v[0] / spatial->cell_size);
+    const GLfloat first_y = floorf(area->v[1] / spatial->cell_size);
+    const GLfloat last_x  = floorf(area->v[2] / spatial->cell_size);
+    const GLfloat last_y  = floorf(area->v[3] / spatial->cell_size);
+    const GLfloat cells   = (last_x - first_x + 1.0f) * (last_y - first_y + 1.0f);
+    GLint         x       = 0;
+    GLint         y       = 0;
+    GLuint        i       = 0;
+
+    spatial->result_count = 0u;
+
+    if (spatial->capacity == 0u) return 0u;
+
+    spatial->stamp++;
+
+    if (!(cells <= (GLfloat)SPATIAL_BUCKETS)) {
+        for (i = 0; i < SPATIAL_BUCKETS; i++) collect_colliders(spatial, &(spatial->buckets[i]), area, exclude);
+
+        return spatial->result_count;
+    }
+
+    for (y = (GLint)first_y; y <= (GLint)last_y; y++) {
+        for (x = (GLint)first_x; x <= (GLint)last_x; x++) {
+            collect_colliders(spatial, &(spatial->buckets[hash_cell(x, y)]), area, exclude);
+        }
+    }
+
+    return spatial->result_count;
+}
+
+GLvoid collect_colliders(SpatialHash* spatial, const SpatialBucket* bucket, const Vec4* area, GLuint exclude) {
+    GLuint i = 0;
+
+    for (i = 0; i < bucket->count; i++) {
+        const GLuint index  = bucket->items[i];
+        const Vec4*  bounds = &(spatial->bounds[index]);
+
+        if (index == exclude || spatial->stamps[index] == spatial->stamp) continue;
+
+        spatial->stamps[index] = spatial->stamp;
+
+        if (bounds->v[0] > area->v[2] || bounds->v[2] < area->v[0] || bounds->v[1] > area->v[3] || bounds->v[3] < area->v[1]) continue;
+
+        spatial->results[spatial->result_count++] = index;
+    }
+}
+
+GLvoid push_colliders(lua_State* L, SpatialHash* spatial, int index) {
+    GLuint i     = 0;
+    GLuint count = 0;
+
+    if (lua_istable(L, index)) {
+        lua_pushvalue(L, index);
+    } else {
+        lua_createtable(L, (int)spatial->result_count, 0);
+    }
+
+    lua_getfield(L, LUA_REGISTRYINDEX, MESH_REGISTRY);
+
+    for (i = 0; i < spatial->result_count; i++) {
+        if (lua_geti(L, -1, (lua_Integer)spatial->results[i] + 1) == LUA_TNIL) {
+            lua_pop(L, 1);
+
+            continue;
+        }
+
+        lua_seti(L, -3, ++count);
+    }
+
+    lua_pop(L, 1);
+
+    for (i = (GLuint)luaL_len(L, -1); i > count; i--) {
+        lua_pushnil(L);
+        lua_seti   (L, -2, i);
+    }
+}
+
+GLint clamp_tile(GLfloat position, GLint limit) {
+    const GLfloat cell = floorf(position);
+
+    if (!(cell > -1.0f))       return -1;
+    if (cell > (GLfloat)limit) return limit;
+
+    return (GLint)cell;
+}
+
+bool solid_tiles(Tilemap* tilemap, GLint first_x, GLint last_x, GLint first_y, GLint last_y) {
+    GLint x = 0;
+    GLint y = 0;
+
+    if (first_x < 0)               first_x = 0;
+    if (first_y < 0)               first_y = 0;
+    if (last_x >= tilemap->width)  last_x  = tilemap->width  - 1;
+    if (last_y >= tilemap->height) last_y  = tilemap->height - 1;
+
+    for (y = first_y; y <= last_y; y++) {
+        for (x = first_x; x <= last_x; x++) {
+            if (tilemap->tiles[(size_t)y * tilemap->width + x] != 0) return true;
+        }
+    }
+
+    return false;
+}
+
+GLvoid delete_spatial_hash(SpatialHash* spatial) {
+    GLuint i = 0;
+
+    if (spatial->buckets != NULL) {
+        for (i = 0; i < SPATIAL_BUCKETS; i++) free(spatial->buckets[i].items);
+    }
+
+    free(spatial->buckets);
+    free(spatial->bounds);
+    free(spatial->ranges);
+    free(spatial->stamps);
+    free(spatial->states);
+    free(spatial->pending);
+    free(spatial->results);
+
+    memset(spatial, 0, sizeof(SpatialHash));
+
+    spatial->cell_size = SPATIAL_CELL_SIZE;
+}
+
+GLuint alloc_entity(EntityStore* store) {
+    if (store->free_count > 0u) return store->free_list[--store->free_count];
+
+    if (store->count == store->capacity) {
+        const GLuint capacity = (store->capacity > 0u) ? store->capacity * 2u : MESH_POOL_CAPACITY;
+        bool         failed   = false;
+        size_t       i        = 0;
+
+        GLvoid** arrays[] = {
+            (GLvoid**)&(store->masks),       (GLvoid**)&(store->position_x),  (GLvoid**)&(store->position_y),
+            (GLvoid**)&(store->position_z),  (GLvoid**)&(store->scale_x),     (GLvoid**)&(store->scale_y),
+            (GLvoid**)&(store->cosine),      (GLvoid**)&(store->sine),        (GLvoid**)&(store->velocity_x),
+            (GLvoid**)&(store->velocity_y),  (GLvoid**)&(store->textures),    (GLvoid**)&(store->cells),
+            (GLvoid**)&(store->first_frame), (GLvoid**)&(store->frame_count), (GLvoid**)&(store->frame_rate),
+            (GLvoid**)&(store->frame_time),  (GLvoid**)&(store->free_list)
+        };
+
+        const size_t sizes[] = {
+            sizeof(GLuint),   sizeof(GLfloat), sizeof(GLfloat),
+            sizeof(GLfloat),  sizeof(GLfloat), sizeof(GLfloat),
+            sizeof(GLfloat),  sizeof(GLfloat), sizeof(GLfloat),
+            sizeof(GLfloat),  sizeof(Handle),   sizeof(Vec4),
+            sizeof(GLfloat),  sizeof(GLfloat), sizeof(GLfloat),
+            sizeof(GLfloat),  sizeof(GLuint)
+        };
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            GLvoid* array = realloc(*arrays[i], capacity * sizes[i]);
+
+            if (array != NULL) {
+                *arrays[i] = array;
+            } else {
+                failed = true;
+            }
+        }
+
+        if (failed) return store->capacity;
+
+        store->capacity = capacity;
+    }
+
+    return store->count++;
+}
+
+GLvoid free_entity(EntityStore* store, GLuint index) {
+    store->masks     [index]              = 0u;
+    store->velocity_x[index]              = 0.0f;
+    store->velocity_y[index]              = 0.0f;
+    store->textures  [index]              = (Handle){ NULL, NULL, 0u };
+    store->free_list[store->free_count++] = index;
+}
+
+GLuint get_entity(EntityStore* store, GLvoid* handle) {
+    const uintptr_t index = (uintptr_t)handle;
+
+    if (index == 0u || index > store->count || !(store->masks[index - 1u] & ENTITY_ALIVE)) return store->capacity;
+
+    return (GLuint)(index - 1u);
+}
+
+GLvoid delete_entity_store(EntityStore* store) {
+    free(store->masks);
+    free(store->position_x);
+    free(store->position_y);
+    free(store->position_z);
+    free(store->scale_x);
+    free(store->scale_y);
+    free(store->cosine);
+    free(store->sine);
+    free(store->velocity_x);
+    free(store->velocity_y);
+    free(store->textures);
+    free(store->cells);
+    free(store->first_frame);
+    free(store->frame_count);
+    free(store->frame_rate);
+    free(store->frame_time);
+    free(store->free_list);
+
+    memset(store, 0, sizeof(EntityStore));
+}
+
+GLvoid update_view(View* view, GLfloat aspect) {
+    if (view->aspect != aspect || view->resolved != view->version) {
+        const Camera* camera      = view->camera;
+        const GLfloat half_width  = aspect / camera->zoom;
+        const GLfloat half_height = 1.0f   / camera->zoom;
+        const GLfloat extent_x    = fabsf(camera->cosine) * half_width + fabsf(camera->sine)   * half_height;
+        const GLfloat extent_y    = fabsf(camera->sine)   * half_width + fabsf(camera->cosine) * half_height;
+
+        view->bounds = (Vec4){ .v = {
+            camera->position.v[0] - extent_x, camera->position.v[1] - extent_y,
+            camera->position.v[0] + extent_x, camera->position.v[1] + extent_y
+        } };
+
+        view->aspect   = aspect;
+        view->resolved = view->version;
+    }
+}
+
+bool cull_model(View* view, const Mat4* model) {
+    const GLfloat half_width  = fabsf(model->m[0][0]) + fabsf(model->m[1][0]);
+    const GLfloat half_height = fabsf(model->m[0][1]) + fabsf(model->m[1][1]);
+
+    if (model->m[3][0] + half_width  < view->bounds.v[0] || model->m[3][0] - half_width  > view->bounds.v[2] ||
+        model->m[3][1] + half_height < view->bounds.v[1] || model->m[3][1] - half_height > view->bounds.v[3]) {
+        view->culled++;
+
+        return true;
+    }
+
+    view->drawn++;
+
+    return false;
+}
+
+GLvoid end_view_frame(View* view) {
+    view->last_drawn  = view->drawn;
+    view->last_culled = view->culled;
+    view->drawn       = 0u;
+    view->culled      = 0u;
+}
+
+GLvoid copy_profile_name(GLchar* destination, const GLchar* name) {
+    GLint i = 0;
+
+    for (i = 0; i < PROFILE_NAME_SIZE - 1 && name[i] != '\0'; i++) {
+        destination[i] = (name[i] == '"' || name[i] == '\\' || (GLubyte)name[i] < 0x20) ? '_' : name[i];
+    }
+
+    destination[i] = '\0';
+}
+
+GLvoid begin_profile_scope(Profiler* profiler, const GLchar* name) {
+    ProfileFrame* frame = &(profiler->frames[profiler->current]);
+    GLint         index = -1;
+
+    if (profiler->depth == PROFILE_DEPTH) {
+        printf("Error (%s): Profile scopes nested deeper than %d.\n", __func__, PROFILE_DEPTH);
+
+        return;
+    }
+
+    if (frame->count < PROFILE_FRAME_SCOPES) {
+        ProfileScope* scope = &(frame->scopes[frame->count]);
+
+        copy_profile_name(scope->name, name);
+
+        scope->start    = monotonic_time();
+        scope->duration = 0.0;
+        scope->depth    = profiler->depth;
+        scope->gpu      = false;
+
+        index = frame->count++;
+    }
+
+    profiler->stack [profiler->depth] = index;
+    profiler->passes[profiler->depth] = -1;
+    profiler->depth++;
+}
+
+GLvoid end_profile_scope(Profiler* profiler) {
+    if (profiler->depth == 0) return;
+
+    profiler->depth--;
+
+    const GLint index = profiler->stack [profiler->depth];
+    const GLint pass  = profiler->passes[profiler->depth];
+
+    if (pass >= 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+
+        profiler->active_pass = -1;
+    }
+
+    if (index >= 0) {
+        ProfileScope* scope = &(profiler->frames[profiler->current].scopes[index]);
+
+        scope->duration = monotonic_time() - scope->start;
+    }
+}
+
+GLvoid begin_profile_pass(Profiler* profiler, const GLchar* name) {
+    const GLint  depth = profiler->depth;
+    GLchar       key[PROFILE_NAME_SIZE];
+    ProfilePass* pass  = NULL;
+    GLint        i     = 0;
+
+    begin_profile_scope(profiler, name);
+
+    if (profiler->depth == depth || profiler->active_pass >= 0 || renderer.running) return;
+
+    copy_profile_name(key, name);
+
+    for (i = 0; i < profiler->pass_count; i++) {
+        if (strcmp(profiler->pass_list[i].name, key) == 0) break;
+    }
+
+    if (i == profiler->pass_count) {
+        if (profiler->pass_count == PROFILE_PASSES) return;
+
+        pass = &(profiler->pass_list[profiler->pass_count++]);
+
+        memset      (pass, 0, sizeof(ProfilePass));
+        strcpy      (pass->name, key);
+        glGenQueries(PROFILE_QUERY_FRAMES, pass->queries);
+    }
+
+    pass = &(profiler->pass_list[i]);
+
+    const GLuint slot = pass->next++ % PROFILE_QUERY_FRAMES;
+
+    pass->starts [slot] = monotonic_time();
+    pass->pending[slot] = true;
+
+    glBeginQuery(GL_TIME_ELAPSED, pass->queries[slot]);
+
+    profiler->active_pass                 = i;
+    profiler->passes[profiler->depth - 1] = i;
+}
+
+GLvoid read_profile_passes(Profiler* profiler) {
+    GLint i = 0;
+    GLint j = 0;
+
+    for (i = 0; i < profiler->pass_count; i++) {
+        ProfilePass* pass = &(profiler->pass_list[i]);
+
+        for (j = 0; j < PROFILE_QUERY_FRAMES; j++) {
+            const GLuint slot      = (pass->next + (GLuint)j) % PROFILE_QUERY_FRAMES;
+            GLint        available = 0;
+            GLuint64     elapsed   = 0;
+
+            if (!pass->pending[slot]) continue;
+
+            glGetQueryObjectiv(pass->queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (!available) continue;
+
+            glGetQueryObjectui64v(pass->queries[slot], GL_QUERY_RESULT, &elapsed);
+
+            pass->pending[slot] = false;
+            pass->time          = (GLdouble)elapsed * 1.0e-6;
+
+            if (profiler->capture_frames > 0 && pass->starts[slot] >= profiler->capture_origin) {
+                ProfileScope scope = { .start = pass->starts[slot], .duration = (GLdouble)elapsed * 1.0e-9, .gpu = true };
+
+                strcpy               (scope.name, pass->name);
+                capture_profile_scope(profiler, &scope);
+            }
+        }
+    }
+}
+
+GLvoid capture_profile_scope(Profiler* profiler, const ProfileScope* scope) {
+    if (profiler->capture_count == profiler->capture_capacity) {
+        const size_t  capacity = (profiler->capture_capacity > 0) ? profiler->capture_capacity * 2 : 4096;
+        ProfileScope* capture  = realloc(profiler->capture, capacity * sizeof(ProfileScope));
+
+        if (capture == NULL) return;
+
+        profiler->capture          = capture;
+        profiler->capture_capacity = capacity;
+    }
+
+    profiler->capture[profiler->capture_count++] = *scope;
+}
+
+GLvoid end_profile_frame(Profiler* profiler, lua_State* L) {
+    const GLdouble    now   = monotonic_time();
+    const RenderState state = read_render_state(&renderer);
+    ProfileFrame*     frame = &(profiler->frames[profiler->current]);
+    GLint             i     = 0;
+
+    while (profiler->depth > 0) end_profile_scope(profiler);
+
+    if (!renderer.running) read_profile_passes(profiler);
+
+    frame->frame_time      = (profiler->frame_start > 0.0) ? now - profiler->frame_start : 0.0;
+    frame->draw_calls      = state.draws   - profiler->draws;
+    frame->state_changes   = state.issued  - profiler->issued;
+    frame->texture_uploads = state.uploads - profiler->uploads;
+    frame->lua_memory      = (size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024u + (size_t)lua_gc(L, LUA_GCCOUNTB, 0);
+
+    if (profiler->capture_frames > 0) {
+        for (i = 0; i < frame->count; i++) capture_profile_scope(profiler, &(frame->scopes[i]));
+
+        if (--profiler->capture_frames == 0) {
+            write_trace(profiler);
+
+            profiler->capture_count = 0;
+        }
+    }
+
+    profiler->current ^= 1;
+    profiler->frames[profiler->current].count = 0;
+
+    profiler->frame_start = now;
+    profiler->draws       = state.draws;
+    profiler->issued      = state.issued;
+    profiler->uploads     = state.uploads;
+}
+
+bool write_trace(Profiler* profiler) {
+    FILE*  file = fopen(profiler->capture_path, "w");
+    size_t i    = 0;
+
+    if (file == NULL) {
+        printf("Error (%s): Could not open \"%s\".\n", __func__, profiler->capture_path);
+
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+
+    for (i = 0; i < profiler->capture_count; i++) {
+        const ProfileScope* scope = &(profiler->capture[i]);
+
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+            scope->name, scope->gpu ? 2 : 1, (scope->start - profiler->capture_origin) * 1.0e6, scope->duration * 1.0e6);
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose (file);
+
+    return true;
+}
+
+GLvoid delete_profile_passes(Profiler* profiler) {
+    GLint i = 0;
+
+    while (profiler->depth > 0) end_profile_scope(profiler);
+
+    for (i = 0; i < profiler->pass_count; i++) glDeleteQueries(PROFILE_QUERY_FRAMES, profiler->pass_list[i].queries);
+
+    profiler->pass_count  = 0;
+    profiler->active_pass = -1;
+}
+
+GLvoid delete_profiler(Profiler* profiler) {
+    free(profiler->capture);
+    free(profiler->capture_path);
+
+    profiler->capture          = NULL;
+    profiler->capture_path     = NULL;
+    profiler->capture_count    = 0;
+    profiler->capture_capacity = 0;
+    profiler->capture_frames   = 0;
+}
+
+Mat4 camera_projection(const Camera* camera, GLfloat aspect) {
+    const GLfloat half_width  = aspect / camera->zoom;
+    const GLfloat half_height = 1.0f   / camera->zoom;
+    const GLfloat x           = camera->position.v[0];
+    const GLfloat y           = camera->position.v[1];
+    Mat4          Projection  = ortho(-half_width, half_width, -half_height, half_height, -10.0f, 10.0f);
+    const GLfloat scale_x     = Projection.m[0][0];
+    const GLfloat scale_y     = Projection.m[1][1];
+
+    Projection.m[0][0] =  scale_x * camera->cosine;
+    Projection.m[0][1] = -scale_y * camera->sine;
+    Projection.m[1][0] =  scale_x * camera->sine;
+    Projection.m[1][1] =  scale_y * camera->cosine;
+    Projection.m[3][0] = -scale_x * ( camera->cosine * x + camera->sine   * y);
+    Projection.m[3][1] = -scale_y * (-camera->sine   * x + camera->cosine * y);
+
+    return Projection;
 }
 
 Mat4 ortho(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat z_near, GLfloat z_far) {
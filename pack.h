@@ -0,0 +1,46 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <stdint.h>
+
+#define PACK_MAGIC     0x50443247u
+#define PACK_VERSION   1u
+#define PACK_NAME_SIZE 64
+#define PACK_ALIGNMENT 16
+#define PACK_CHANNELS  4
+
+typedef enum {
+    PACK_TEXTURE = 1,
+    PACK_SHADER  = 2,
+    PACK_SCRIPT  = 3
+} PackType;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+} PackHeader;
+
+typedef struct {
+    char     name[PACK_NAME_SIZE];
+    uint32_t type;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint64_t offset;
+    uint64_t size;
+} PackEntry;
+
+static inline void pack_color_key(uint8_t* pixels, uint64_t pixel_count) {
+    uint64_t i = 0;
+
+    for (i = 0; i < pixel_count; i++, pixels += PACK_CHANNELS) {
+        const int magenta = pixels[0] == 255u && pixels[1] != 255u && pixels[2] == 255u;
+        const int green   = pixels[0] != 255u && pixels[1] == 255u && pixels[2] != 255u;
+
+        if (magenta || green) pixels[3] = 0u;
+    }
+}
+
+#endif
@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "./lua54/lua.h"
+#include "./lua54/lualib.h"
+#include "./lua54/lauxlib.h"
+#include "./stb/stb_image.h"
+#include "./pack.h"
+
+typedef struct {
+    unsigned char* data;
+    size_t         size;
+    size_t         capacity;
+} Buffer;
+
+bool append       (Buffer*, const void*, size_t);
+int  write_chunk  (lua_State*, const void*, size_t, void*);
+bool has_extension(const char*, const char*);
+bool pack_texture (const char*, PackEntry*, Buffer*);
+bool pack_shader  (const char*, PackEntry*, Buffer*);
+bool pack_script  (const char*, PackEntry*, Buffer*);
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <output.pak> <file> [file...]\n", argv[0]);
+        printf("Files ending in .glsl are stored as shader sources, .lua as precompiled Lua bytecode\n");
+        printf("and anything else as a decoded, flipped RGBA texture with colour keys turned into alpha.\n");
+        printf("Entries are named exactly as given, so pass the same paths the game uses (e.g. ./img/player.bmp).\n");
+
+        return EXIT_FAILURE;
+    }
+
+    const int  entry_count = argc - 2;
+    PackEntry* entries     = calloc(entry_count, sizeof(PackEntry));
+    Buffer     data        = { NULL, 0, 0 };
+    int        i           = 0;
+
+    if (entries == NULL) {
+        printf("Error (%s): Failed to allocate entry table.\n", __func__);
+
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < entry_count; i++) {
+        const char* path   = argv[i + 2];
+        PackEntry*  entry  = &(entries[i]);
+        bool        packed = false;
+
+        if (strlen(path) >= PACK_NAME_SIZE) {
+            printf("Error (%s): Name too long: %s.\n", __func__, path);
+            free  (entries);
+            free  (data.data);
+
+            return EXIT_FAILURE;
+        }
+
+        strcpy(entry->name, path);
+
+        while (data.size % PACK_ALIGNMENT != 0) append(&data, "", 1);
+
+        entry->offset = data.size;
+
+        if (has_extension(path, ".glsl")) {
+            packed = pack_shader(path, entry, &data);
+        } else if (has_extension(path, ".lua")) {
+            packed = pack_script(path, entry, &data);
+        } else {
+            packed = pack_texture(path, entry, &data);
+        }
+
+        if (!packed) {
+            free(entries);
+            free(data.data);
+
+            return EXIT_FAILURE;
+        }
+
+        entry->size = data.size - entry->offset;
+    }
+
+    size_t table_size = sizeof(PackHeader) + entry_count * sizeof(PackEntry);
+
+    table_size = (table_size + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+
+    for (i = 0; i < entry_count; i++) entries[i].offset += table_size;
+
+    PackHeader header = {
+        PACK_MAGIC, PACK_VERSION, (uint32_t)entry_count, 0u
+    };
+
+    static const char zeros[PACK_ALIGNMENT];
+    FILE*             file = fopen(argv[1], "wb");
+
+    if (file == NULL) {
+        printf("Error (%s): Failed to open output file: %s.\n", __func__, argv[1]);
+        free  (entries);
+        free  (data.data);
+
+        return EXIT_FAILURE;
+    }
+
+    fwrite(&header, sizeof(PackHeader), 1, file);
+    fwrite(entries, sizeof(PackEntry), entry_count, file);
+    fwrite(zeros, 1, table_size - sizeof(PackHeader) - entry_count * sizeof(PackEntry), file);
+    fwrite(data.data, 1, data.size, file);
+    fclose(file);
+
+    printf("%s: %d entries, %zu bytes.\n", argv[1], entry_count, table_size + data.size);
+
+    free(entries);
+    free(data.data);
+
+    return EXIT_SUCCESS;
+}
+
+bool append(Buffer* buffer, const void* bytes, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t         capacity = (buffer->capacity > 0) ? buffer->capacity : 4096;
+        unsigned char* data     = NULL;
+
+        while (buffer->size + size > capacity) capacity *= 2;
+
+        data = realloc(buffer->data, capacity);
+
+        if (data == NULL) return false;
+
+        buffer->data     = data;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(&(buffer->data[buffer->size]), bytes, size);
+
+    buffer->size += size;
+
+    return true;
+}
+
+int write_chunk(lua_State* L, const void* bytes, size_t size, void* buffer) {
+    return append(buffer, bytes, size) ? 0 : 1;
+}
+
+bool has_extension(const char* path, const char* extension) {
+    const size_t path_length      = strlen(path);
+    const size_t extension_length = strlen(extension);
+
+    return path_length >= extension_length && strcmp(&(path[path_length - extension_length]), extension) == 0;
+}
+
+bool pack_texture(const char* path, PackEntry* entry, Buffer* data) {
+    int            width    = 0;
+    int            height   = 0;
+    int            channels = 0;
+    unsigned char* pixels   = NULL;
+
+    stbi_set_flip_vertically_on_load(true);
+
+    pixels = stbi_load(path, &width, &height, &channels, PACK_CHANNELS);
+
+    if (pixels == NULL) {
+        printf("Error (%s): Failed to load texture file: %s.\n", __func__, path);
+
+        return false;
+    }
+
+    entry->type     = PACK_TEXTURE;
+    entry->width    = width;
+    entry->height   = height;
+    entry->channels = PACK_CHANNELS;
+
+    if (channels != 2 && channels != 4) pack_color_key(pixels, (uint64_t)width * height);
+
+    const bool appended = append(data, pixels, (size_t)width * height * PACK_CHANNELS);
+
+    stbi_image_free(pixels);
+
+    return appended;
+}
+
+bool pack_shader(const char* path, PackEntry* entry, Buffer* data) {
+    FILE* file = fopen(path, "rb");
+
+    if (file == NULL) {
+        printf("Error (%s): File not found: %s.\n", __func__, path);
+
+        return false;
+    }
+
+    char   chunk[4096];
+    size_t read     = 0;
+    bool   appended = true;
+
+    entry->type = PACK_SHADER;
+
+    while (appended && (read = fread(chunk, 1, sizeof(chunk), file)) > 0) appended = append(data, chunk, read);
+
+    fclose(file);
+
+    return appended && append(data, "", 1);
+}
+
+bool pack_script(const char* path, PackEntry* entry, Buffer* data) {
+    lua_State* L = luaL_newstate();
+
+    if (luaL_loadfile(L, path) != LUA_OK) {
+        printf   ("Error (%s): %s\n", __func__, lua_tostring(L, -1));
+        lua_close(L);
+
+        return false;
+    }
+
+    entry->type = PACK_SCRIPT;
+
+    const int status = lua_dump(L, write_chunk, data, false);
+
+    lua_close(L);
+
+    return status == 0;
+}
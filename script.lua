@@ -1,15 +1,14 @@
 local framebuffer = {}
 local player      = {}
-local stone       = {}
 local text        = {}
 
-function player:create()
+function player:create(texture)
     local o = {}
 
     setmetatable(o, {__index = player})
 
-    o.mesh            = engine.create_mesh ()
-    o.texture         = engine.load_texture("./img/player.bmp")
+    o.mesh            = engine.create_mesh()
+    o.texture         = texture
     o.animation_speed = 1.0
     o.speed           = 0.1
 
@@ -30,16 +29,15 @@ function player:create()
 end
 
 function player:delete()
-    engine.delete_texture(self.texture)
-    engine.delete_mesh   (self.mesh)
+    self.mesh:delete()
 end
 
 function player:set_scale(h, w)
-    engine.set_scale(self.mesh, w, h)
+    self.mesh:set_scale(w, h)
 end
 
 function player:set_rotate(angle)
-    engine.set_rotate(self.mesh, angle)
+    self.mesh:set_rotate(angle)
 end
 
 function player:set_position(x, y, z)
@@ -83,7 +81,7 @@ function player:update(window, clock, ID)
         self.tex_coords.v = 2.0
     end
 
-    engine.set_position(self.mesh, self.position.x, self.position.y, self.position.z)
+    self.mesh:set_position(self.position.x, self.position.y, self.position.z)
 end
 
 function player:draw(window, shader)
@@ -92,100 +90,37 @@ function player:draw(window, shader)
     local du = self.tex_coords.du
     local dv = self.tex_coords.dv
 
-    engine.draw(self.mesh, window, shader, self.texture, u, v, du, dv)
+    self.mesh:draw(window, shader, self.texture, u, v, du, dv)
 end
 
-function stone:create()
-    local o = {}
-
-    setmetatable(o, {__index = stone})
-
-    o.mesh = engine.create_mesh()
-
-    o.tex_coords = {
-        u  = 0.0,
-        v  = 0.0,
-        du = 0.125,
-        dv = 0.125
-    }
-
-    return o
-end
+function create_ground(texture)
+    local ground = engine.create_tilemap(15, 1, 0.2, texture, 8, 8)
 
-function delete_stones(stones)
-    for _, s in ipairs(stones) do
-        s:destroy()
+    for x = 0, 14 do
+        engine.set_tile(ground, x, 0, 1)
     end
-end
-
-function stone:set_scale(h, w)
-    engine.set_scale(self.mesh, w, h)
-end
 
-function stone:set_rotate(angle)
-    engine.set_rotate(self.mesh, angle)
-end
-
-function stone:set_position(x, y, z)
-    engine.set_position(self.mesh, x, y, z)
-end
-
-function stone:draw(window, shader, texture)
-    local u  = self.tex_coords.u
-    local v  = self.tex_coords.v
-    local du = self.tex_coords.du
-    local dv = self.tex_coords.dv
+    engine.set_tilemap_position(ground, -1.5, -0.5, -0.1)
 
-    engine.draw(self.mesh, window, shader, texture, u, v, du, dv)
+    return ground
 end
 
-function stone:destroy()
-    engine.delete_mesh(self.mesh)
-end
-
-function create_stones()
-    local stones = {}
-
-    for i = -7, 7 do
-        local new_stone = stone:create()
-
-        new_stone:set_scale   (0.1, 0.1)
-        new_stone:set_rotate  (0.0)
-        new_stone:set_position(i * 0.2, -0.4, -0.1)
-
-        table.insert(stones, new_stone)
-    end
-
-    return stones
-end
-
-function draw_stones(window, stones, shader, texture)
-    for _, s in ipairs(stones) do
-        s:draw(window, shader, texture)
-    end
-end
-
-function text:create(scale)
+function text:create(texture)
     local o = {}
 
     setmetatable(o, {__index = text})
 
-    o.mesh    = engine.create_mesh ()
-    o.texture = engine.load_texture("./img/fontmap.bmp")
+    o.font = engine.create_font(texture, 16, 16)
 
     return o
 end
 
 function text:delete()
-    engine.delete_texture(self.texture)
-    engine.delete_mesh   (self.mesh)
+    self.font:delete()
 end
 
-function text:draw(window, shader, scale, x, y, z, u, v)
-    engine.set_scale   (self.mesh, scale, scale)
-    engine.set_position(self.mesh, x, y, z)
-
-    engine.draw(self.mesh, window, shader, self.texture, u, v, 0.0625, 0.0625)
+function text:draw(window, shader, string, x, y, size)
+    self.font:draw(window, shader, string, x, y, size)
 end
 
 function script()
@@ -199,9 +134,11 @@ function script()
 
         engine.set_scale(framebuffer_mesh, window_width / window_height, 1.0)
 
-        local player = player:create()
-        local stones = create_stones()
-        local text   = text:create  ()
+        local atlas, textures = engine.create_atlas({"./img/player.bmp", "./img/stone.bmp", "./img/fontmap.bmp"}, 1, 2048)
+
+        local player = player:create(textures[1])
+        local ground = create_ground(textures[2])
+        local text   = text:create  (textures[3])
 
         player:set_scale          (0.1, 0.1)
         player:set_position       (0.0, 0.0, 0.0)
@@ -209,48 +146,48 @@ function script()
         player:set_speed          (0.01)
         player:set_animation_speed(8.0)
 
-        local texture = engine.load_texture ("./img/stone.bmp")
-        local shader  = engine.create_shader("./glsl/vertex.glsl", "./glsl/fragment.glsl")
+        local shader        = engine.create_shader("./glsl/vertex.glsl", "./glsl/fragment.glsl")
+        local opaque_shader = engine.create_shader("./glsl/vertex.glsl", "./glsl/opaque.glsl")
+        local ground_shader = engine.texture_opaque(textures[2]) and opaque_shader or shader
 
         local FPS = 60
 
-        while not engine.window_should_close(window) do
-            local frame_start_time = os.clock()
-
+        local function update(dt)
             if engine.get_key(window, KEY_ESC) then engine.set_window_should_close(window) end
 
+            player:update(window, engine.time(), 0)
+        end
+
+        local function render(alpha)
+            engine.begin_pass        ("scene")
             engine.enable_framebuffer(framebuffer)
+            engine.begin_batch       ()
 
-            text:draw(window, shader, 0.05, -1.5, 0.9, 0.0, 0.0, 3.0)
-            text:draw(window, shader, 0.05, -1.4, 0.9, 0.0, 1.0, 3.0)
-            text:draw(window, shader, 0.05, -1.3, 0.9, 0.0, 2.0, 3.0)
-            text:draw(window, shader, 0.05, -1.2, 0.9, 0.0, 3.0, 3.0)
-            text:draw(window, shader, 0.05, -1.1, 0.9, 0.0, 4.0, 3.0)
+            text:draw(window, shader, "ABCDE", -1.55, 0.85, 0.1)
 
-            player:update(window, os.clock(), 0)
-            player:draw  (window, shader)
+            player:draw(window, shader)
 
-            draw_stones(window, stones, shader, texture)
+            engine.draw_tilemap(ground, window, ground_shader)
 
+            engine.end_batch          ()
+            engine.end_pass           ()
+            engine.begin_pass         ("blit")
             engine.disable_framebuffer(framebuffer, 0.5, 0.5, 1.0)
             engine.draw               (framebuffer_mesh, window, shader, engine.use_framebuffer(framebuffer), 0.0, 0.0, 1.0, 1.0)
-
-            engine.swap_buffers(window)
-            engine.poll_events ()
-
-            local frame_end_time = os.clock()
-            local wait_time      = (1.0 / FPS) - (frame_end_time - frame_start_time)
-
-            if wait_time > 0 then engine.delay(wait_time) end
+            engine.end_pass           ()
         end
 
+        engine.set_vsync(window, true)
+        engine.run      (window, update, render, 60, FPS)
+
         text:delete  ()
         player:delete()
 
-        delete_stones(stones)
+        engine.delete_tilemap(ground)
 
-        engine.delete_texture    (texture)
+        engine.delete_atlas      (atlas)
         engine.delete_shader     (shader)
+        engine.delete_shader     (opaque_shader)
         engine.delete_framebuffer(framebuffer)
         engine.delete_window     (window)
     end